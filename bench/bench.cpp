@@ -0,0 +1,236 @@
+#include "bench.h"
+
+#include <pong_display.h>
+
+#include <stdio.h>
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#else
+#include <native_hal.h>
+#include <chrono>
+#include <new>
+#include <stdlib.h>
+#endif
+
+// Column widths of the result table
+#define BENCH_NAME_WIDTH   24
+#define BENCH_VALUE_WIDTH  12
+
+#if defined(__AVR__)
+
+// Timer1 free-running at F_CPU, overflows extend it to 32 bits
+static volatile uint16_t timer1_overflows;
+
+ISR(TIMER1_OVF_vect)
+{
+    timer1_overflows++;
+}
+
+static void timerStart()
+{
+    TCCR1B = 0;
+    TCCR1A = 0;
+    TCNT1 = 0;
+    timer1_overflows = 0;
+    TIFR1 = _BV(TOV1);
+    TIMSK1 = _BV(TOIE1);
+    TCCR1B = _BV(CS10);
+}
+
+// Elapsed cycles since timerStart()
+static uint64_t timerStop()
+{
+    TCCR1B = 0;
+    uint32_t cycles = ((uint32_t)timer1_overflows << 16) | TCNT1;
+    if (TIFR1 & _BV(TOV1)) cycles += 0x10000UL;
+    TIMSK1 = 0;
+    return cycles;
+}
+
+#else
+
+// Every operator new in the process is counted, so String or container use in an
+// operation shows up as allocations per op
+static uint32_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *ptr = malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+static std::chrono::steady_clock::time_point timer_start;
+
+static void timerStart()
+{
+    timer_start = std::chrono::steady_clock::now();
+}
+
+// Elapsed host nanoseconds since timerStart()
+static uint64_t timerStop()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - timer_start).count();
+}
+
+#endif
+
+// Cost of one empty operation, in timer units x 100
+static uint32_t empty_cost = 0;
+
+static void emptyOp(uint32_t iteration)
+{
+    (void)iteration;
+}
+
+// Time 'iterations' calls of 'op' in timer units x 100 per call
+static uint32_t timeOp(BenchOp op, uint32_t iterations)
+{
+    timerStart();
+    for (uint32_t i = 0; i < iterations; i++) op(i);
+    uint64_t elapsed = timerStop();
+    return (uint32_t)((elapsed * 100) / iterations);
+}
+
+static void printPadded(const char *text, uint8_t width, bool right)
+{
+    uint8_t length = strlen(text);
+    if (!right) Serial.print(text);
+    for (uint8_t i = length; i < width; i++) Serial.print(' ');
+    if (right) Serial.print(text);
+}
+
+// Right-aligned column with two decimals (value is x 100)
+static void printColumn(uint32_t hundredths)
+{
+    char text[BENCH_VALUE_WIDTH + 1];
+    snprintf(text, sizeof(text), "%lu.%02lu", (unsigned long)(hundredths / 100), (unsigned long)(hundredths % 100));
+    printPadded(text, BENCH_VALUE_WIDTH, true);
+}
+
+static void printHeading(const __FlashStringHelper *text, bool first)
+{
+    char buffer[BENCH_NAME_WIDTH + 1];
+    strncpy_P(buffer, (const char *)text, BENCH_NAME_WIDTH);
+    buffer[BENCH_NAME_WIDTH] = '\0';
+    printPadded(buffer, first ? BENCH_NAME_WIDTH : BENCH_VALUE_WIDTH, !first);
+}
+
+#if !defined(__AVR__)
+
+// FNV-1a over the panel byte stream, each byte tagged as command or data
+static uint32_t traffic_hash;
+
+static void hashPanelByte(bool data, uint8_t value)
+{
+    traffic_hash = (traffic_hash ^ (data ? 0x100 : 0) ^ value) * 16777619UL;
+}
+
+// I2C: the control byte of each transaction says what the rest of it is
+static void i2cTraffic(uint8_t address, const uint8_t *data, uint8_t length)
+{
+    (void)address;
+    for (uint8_t i = 1; i < length; i++) hashPanelByte(data[0] & 0x40, data[i]);
+}
+
+// SPI: the data/command pin does
+static void spiTraffic(uint8_t value)
+{
+    hashPanelByte(nativeGetPin(OLED_DC) == HIGH, value);
+}
+
+#endif
+
+void benchTrafficBegin()
+{
+#if !defined(__AVR__)
+    traffic_hash = 2166136261UL;
+    nativeSetI2CSink(i2cTraffic);
+    nativeSetSPISink(spiTraffic);
+#endif
+}
+
+void benchTrafficEnd(const __FlashStringHelper *name)
+{
+#if !defined(__AVR__)
+    nativeSetI2CSink(nullptr);
+    nativeSetSPISink(nullptr);
+
+    char text[16];
+    snprintf(text, sizeof(text), "0x%08lx", (unsigned long)traffic_hash);
+    printHeading(name, true);
+    printPadded(text, BENCH_VALUE_WIDTH, true);
+    Serial.println();
+#else
+    (void)name;
+#endif
+}
+
+void benchBegin()
+{
+    printHeading(F("case"), true);
+#if defined(__AVR__)
+    printHeading(F("cycles/op"), false);
+    printHeading(F("us/op"), false);
+#else
+    printHeading(F("ns/op"), false);
+    printHeading(F("bus B/op"), false);
+    printHeading(F("bus us/op"), false);
+    printHeading(F("allocs/op"), false);
+#endif
+    Serial.println();
+
+    empty_cost = timeOp(emptyOp, 1000);
+}
+
+void benchRun(const __FlashStringHelper *name, BenchOp op, uint32_t iterations)
+{
+#if !defined(__AVR__)
+    iterations *= BENCH_NATIVE_SCALE;
+    uint32_t bus_bytes = nativeBusStats().bytes;
+    uint64_t bus_us = nativeBusStats().busy_us;
+    uint32_t allocated = allocations;
+#endif
+
+    uint32_t cost = timeOp(op, iterations);
+    cost = cost > empty_cost ? cost - empty_cost : 0;
+
+    printHeading(name, true);
+#if defined(__AVR__)
+    printColumn(cost);
+    printColumn(cost / (F_CPU / 1000000UL));
+#else
+    printColumn(cost);
+    printColumn((uint32_t)(((uint64_t)(nativeBusStats().bytes - bus_bytes) * 100) / iterations));
+    printColumn((uint32_t)(((nativeBusStats().busy_us - bus_us) * 100) / iterations));
+    printColumn((uint32_t)(((uint64_t)(allocations - allocated) * 100) / iterations));
+#endif
+    Serial.println();
+}
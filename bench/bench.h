@@ -0,0 +1,30 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Arduino.h>
+
+// Minimal benchmark harness for the bench_native and bench_uno envs. Each case runs an
+// operation a fixed number of times and prints one line over Serial:
+//   native: ns/op (host time), bus bytes/op and bus time/op (simulated I2C/SPI, at the
+//           configured clock), heap allocations/op
+//   uno:    cycles/op and us/op, counted with Timer1 at the full 16 MHz clock
+// The cost of an empty operation is measured first and subtracted from every case.
+
+// Operation under test, called with the iteration number
+typedef void (*BenchOp)(uint32_t iteration);
+
+// Print the header and calibrate the empty operation cost
+void benchBegin();
+
+// Run 'op' 'iterations' times (native runs BENCH_NATIVE_SCALE times as many) and print its line
+void benchRun(const __FlashStringHelper *name, BenchOp op, uint32_t iterations);
+
+// Native only: hash the command and data bytes the panel receives between these calls,
+// whichever bus carries them, and print it (no-ops on the Uno)
+void benchTrafficBegin();
+void benchTrafficEnd(const __FlashStringHelper *name);
+
+// Host runs are cheap and noisy, so they repeat every case this many times more
+#define BENCH_NATIVE_SCALE 1000
+
+#endif
@@ -0,0 +1,247 @@
+// Hot path benchmarks, built by the bench_native and bench_uno envs instead of the game.
+// Each case mirrors what the game does at runtime (see src/main.cpp) on the same display,
+// simulation and animation code. Run before and after a performance change and compare.
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <fireworks.h>
+#include <pong_display.h>
+#include <pong_layout.h>
+#include <pong_record.h>
+#include <pong_render.h>
+#include <pong_sim.h>
+#include <pong_text.h>
+#include <pong_twi.h>
+
+#include "bench.h"
+
+#if !defined(__AVR__)
+#include <native_hal.h>
+#endif
+
+#if PONG_DISPLAY_SPI
+static PongDisplay display(PanelSPI(OLED_DC, -1, OLED_CS));
+#else
+static PongDisplay display(PanelI2C(-1));
+#endif
+static PongState state;
+static RallyView view;
+static FireworksDecoder fireworks;
+
+// Same button pattern for every run: hold up, then down, 64 ticks each
+static PongInputs benchInputs(uint32_t iteration)
+{
+    PongInputs inputs = { (iteration & 64) != 0, (iteration & 64) == 0 };
+    return inputs;
+}
+
+// One simulation tick (ball sweep, AI, paddles)
+static void opSimTick(uint32_t iteration)
+{
+    pongStep(state, benchInputs(iteration));
+}
+
+// Full 1 KB buffer transfer
+static void opFlushFull(uint32_t iteration)
+{
+    (void)iteration;
+    display.display();
+}
+
+// The ticks between two renders
+static void stepFrame(uint32_t iteration)
+{
+    for (uint8_t i = 0; i < 4; i++) pongStep(state, benchInputs(iteration * 4 + i));
+}
+
+// One tick drawn into the display (subtract "sim tick" for the drawing alone)
+static void opRallyDraw(uint32_t iteration)
+{
+    pongStep(state, benchInputs(iteration));
+    drawRally(display, view, state);
+}
+
+// One rally frame with a blocking partial flush
+static void opRallyFrame(uint32_t iteration)
+{
+    stepFrame(iteration);
+    drawRally(display, view, state);
+    display.flushDirty();
+}
+
+// One rally frame handed to the background transfer, as renderRally() does: only the time
+// the loop spends on it counts. A frame drawn while the previous one is still on the bus
+// goes out with the next.
+static void opRallyFrameAsync(uint32_t iteration)
+{
+    stepFrame(iteration);
+    drawRally(display, view, state);
+    display.flushAsync();
+}
+
+#if PONG_RECORD
+// One rally frame of a recorded match: the trace's inputs for the ticks, then the same
+// redraw and partial flush as opRallyFrame(). The trace starts over when it runs out.
+static void opReplayFrame(uint32_t iteration)
+{
+    (void)iteration;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        PongInputs inputs;
+        if (!replayNext(inputs))
+        {
+            replayBegin(state);
+            replayNext(inputs);
+        }
+        pongStep(state, inputs);
+    }
+    drawRally(display, view, state);
+    display.flushDirty();
+}
+
+// Replay the match saved in EEPROM: the last one played on this board, or the file given
+// to the native bench with --eeprom. Without one, a trace of the bench inputs is saved first.
+static bool loadReplay()
+{
+    if (replayBegin(state)) return true;
+
+    PongState end;
+    pongReset(end, 1);
+    recordBegin(end);
+    for (uint32_t i = 0; i < 4000; i++)
+    {
+        PongInputs inputs = benchInputs(i);
+        recordTick(end, inputs);
+        pongStep(end, inputs);
+    }
+    recordSave(end);
+    return replayBegin(state);
+}
+#endif
+
+#if !PONG_PAGE_RENDER
+// One fireworks frame applied to the RAM buffer, looping over the animation
+static void opFireworksDecode(uint32_t iteration)
+{
+    (void)iteration;
+    if (!fireworksDecodeFrame(fireworks, display.getBuffer()))
+    {
+        fireworksBegin(fireworks);
+        fireworksDecodeFrame(fireworks, display.getBuffer());
+    }
+}
+#endif
+
+// One fireworks frame streamed from PROGMEM to the panel, as the victory screen plays it
+static void opFireworksStream(uint32_t iteration)
+{
+    (void)iteration;
+    if (!fireworksNextFrame(fireworks))
+    {
+        fireworksBegin(fireworks);
+        fireworksNextFrame(fireworks);
+    }
+
+    FireworksRun run;
+    display.beginPanelWrite();
+    while (fireworksNextRun(fireworks, run))
+    {
+        display.writePanel_P(run.offset, run.data, run.length, run.repeat);
+    }
+    display.endPanelWrite();
+}
+
+// Scoreboard line assembly only
+static void opScoreboardText(uint32_t iteration)
+{
+    TextBuffer scoreboard;
+    scoreboard.append_P(PSTR("[CPU "));
+    scoreboard.appendUnsigned(iteration % 5);
+    scoreboard.append_P(PSTR(" : "));
+    scoreboard.appendUnsigned(iteration % 3);
+    scoreboard.append_P(PSTR(" PLAYER]"));
+}
+
+// Main menu and its button press, drawn without flushing (text and boxes alone)
+static void opMenuDraw(uint32_t iteration)
+{
+    (void)iteration;
+    drawMenu(display);
+    drawMenuPress(display);
+}
+
+// Goal banner, drawn and flushed like renderGoalBanner() (over a fresh court each time, so
+// the page renderer's display list does not fill up)
+static void opGoalBanner(uint32_t iteration)
+{
+    drawCourt(display, view);
+    drawGoalBanner(display, (iteration & 1) ? UI_PLAYER_SCORES : UI_CPU_SCORES, iteration % 5, iteration % 3);
+    display.display();
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    display.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+
+    pongReset(state, 1);
+    benchBegin();
+    benchRun(F("sim tick"), opSimTick, 1000);
+    benchRun(F("text scoreboard"), opScoreboardText, 1000);
+
+    display.clearDisplay();
+    benchRun(F("flush full"), opFlushFull, 20);
+
+    drawCourt(display, view);
+    pongReset(state, 1);
+    drawRally(display, view, state);
+    display.display();
+    benchRun(F("rally draw (1 tick)"), opRallyDraw, 1000);
+    display.flushDirty();
+    benchRun(F("rally frame (4 ticks)"), opRallyFrame, 200);
+    benchRun(F("rally frame async"), opRallyFrameAsync, 200);
+    twiFinish();
+#if PONG_RECORD
+    if (loadReplay())
+    {
+        drawRally(display, view, state);
+        benchRun(F("replay frame"), opReplayFrame, 200);
+    }
+#endif
+
+#if !PONG_PAGE_RENDER
+    fireworksBegin(fireworks);
+    benchRun(F("fireworks decode"), opFireworksDecode, 100);
+#endif
+    fireworksBegin(fireworks);
+    benchRun(F("fireworks stream"), opFireworksStream, 22);
+
+    benchRun(F("menu draw"), opMenuDraw, 100);
+    benchRun(F("goal banner"), opGoalBanner, 20);
+
+    // Fixed sequence of full, partial and fireworks writes; the I2C and SPI builds, with
+    // either renderer, must print the same hash
+    benchTrafficBegin();
+    drawCourt(display, view);
+    pongReset(state, 1);
+    drawRally(display, view, state);
+    display.display();
+    for (uint32_t i = 0; i < 200; i++) opRallyFrame(i);
+    fireworksBegin(fireworks);
+    for (uint32_t i = 0; i < 22; i++) opFireworksStream(i);
+    for (uint32_t i = 0; i < 4; i++) opGoalBanner(i);
+    benchTrafficEnd(F("panel traffic"));
+}
+
+void loop()
+{
+}
+
+#if !defined(__AVR__)
+int main(int argc, char **argv)
+{
+    if (argc > 2 && !strcmp(argv[1], "--eeprom")) nativeEEPROMLoad(argv[2]);
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,38 @@
+#ifndef FIREWORKS_H
+#define FIREWORKS_H
+
+#include <Arduino.h>
+
+// Streaming decoder for the delta-coded fireworks animation (see fireworks_delta.h).
+// Frames are read straight from PROGMEM, either as runs of changed bytes to send to the
+// panel or applied in place to an SSD1306 page buffer holding the previous frame.
+struct FireworksDecoder
+{
+    uint16_t position;  // Offset of the next token in the stream
+    uint16_t offset;    // Page buffer offset reached in the current frame
+    uint8_t frame;      // Frames started so far
+};
+
+// One run of changed bytes, always within a single page
+struct FireworksRun
+{
+    uint16_t offset;    // Page buffer offset (page * 128 + column)
+    uint8_t length;
+    bool repeat;        // True: data points at one byte repeated 'length' times
+    const uint8_t *data; // PROGMEM
+};
+
+// Rewind to the first frame (a key frame, so no particular starting image is needed)
+void fireworksBegin(FireworksDecoder &decoder);
+
+// Start the next frame. Returns false once every frame has been played.
+bool fireworksNextFrame(FireworksDecoder &decoder);
+
+// Next changed run of the current frame. Returns false at the end of the frame.
+bool fireworksNextRun(FireworksDecoder &decoder, FireworksRun &run);
+
+// Start the next frame and apply all of it to a 128x64 page buffer holding the previous one.
+// Returns false once every frame has been played.
+bool fireworksDecodeFrame(FireworksDecoder &decoder, uint8_t *buffer);
+
+#endif
@@ -0,0 +1,82 @@
+// Generated by tools/encode_fireworks.py from include/fireworks_ssd1306.h, do not edit.
+//
+// Fireworks victory animation: 11 frames of 128x64 in SSD1306 page layout, with the court
+// border baked in. The first frame is a key frame, the others are delta-coded against the
+// previous frame. 915 bytes, down from 11264 raw bitmap bytes. Decode with fireworks.h.
+//
+// Stream format, per frame, until all 1024 page bytes are covered:
+//   0x00-0x7F  skip (n + 1) bytes that are unchanged from the previous frame
+//   0x80-0xBF  (n + 1) literal bytes follow
+//   0xC0-0xFF  the next byte, repeated (n + 1) times
+// Literal and repeat runs stay within one page (one panel address window each), with
+// unchanged gaps of up to 10 bytes resent as literals. 154 windows for the whole animation.
+#ifndef FIREWORKS_DELTA_H
+#define FIREWORKS_DELTA_H
+
+#include <Arduino.h>
+
+const uint16_t FIREWORKS_FRAME_BYTES = 1024;
+const uint8_t FIREWORKS_FRAME_COUNT = 11;
+
+const uint8_t fireworks_stream[] PROGMEM = {
+	0x80, 0xff, 0xff, 0x01, 0xfd, 0x01, 0x80, 0xff, 0x80, 0xff, 0xf3, 0x00, 0x80, 0x80, 0xff, 0x00,
+	0xc8, 0x00, 0x80, 0xff, 0x80, 0xff, 0xee, 0x00, 0x89, 0x26, 0x1c, 0xff, 0x3e, 0x3e, 0xff, 0xf4,
+	0xe6, 0x80, 0x80, 0xff, 0x00, 0xc4, 0x00, 0x80, 0xff, 0x80, 0xff, 0xf6, 0x00, 0x84, 0x01, 0x03,
+	0x0e, 0x78, 0xe0, 0xff, 0x00, 0x82, 0x00, 0x00, 0xff, 0x80, 0xff, 0xff, 0x00, 0xfd, 0x00, 0x80,
+	0xff, 0x80, 0xff, 0xff, 0x00, 0xfd, 0x00, 0x80, 0xff, 0x80, 0xff, 0xfd, 0x00, 0x82, 0xe0, 0xf0,
+	0xc0, 0xfc, 0x00, 0x80, 0xff, 0x80, 0xff, 0xfc, 0x80, 0x83, 0x8f, 0xff, 0xff, 0xfe, 0xfc, 0x80,
+	0x80, 0xff, 0x7f, 0x2c, 0x84, 0x80, 0x00, 0x00, 0x20, 0xe0, 0xc3, 0x00, 0x84, 0xe0, 0x20, 0x00,
+	0x00, 0x80, 0x71, 0x8d, 0xc1, 0x43, 0x62, 0x26, 0x9c, 0xff, 0x3e, 0x3e, 0xfd, 0xf4, 0xe6, 0xc2,
+	0x41, 0x81, 0x74, 0x81, 0x06, 0x07, 0xc3, 0x00, 0x86, 0x07, 0x04, 0x01, 0x03, 0x02, 0x00, 0x00,
+	0x7f, 0x05, 0x82, 0xc0, 0xf0, 0xf8, 0x78, 0x85, 0x80, 0x60, 0x78, 0x0e, 0x03, 0x01, 0x79, 0x82,
+	0x1f, 0xff, 0xf0, 0x7b, 0x83, 0x80, 0x83, 0xff, 0xfa, 0x3d, 0x7f, 0x7f, 0x2c, 0x8c, 0x81, 0x42,
+	0x62, 0x26, 0x94, 0xff, 0x3e, 0x3e, 0xfd, 0xf4, 0xe6, 0xc2, 0x40, 0x7d, 0x82, 0x00, 0x03, 0x00,
+	0x0b, 0x83, 0x80, 0xc0, 0x60, 0x20, 0xc2, 0x30, 0x80, 0x10, 0x73, 0x84, 0x00, 0x60, 0x7c, 0x07,
+	0x01, 0x73, 0x83, 0x18, 0xf0, 0xe0, 0x80, 0xc4, 0x00, 0x78, 0x83, 0x01, 0x1f, 0x5f, 0x60, 0x7c,
+	0xc2, 0x80, 0x3d, 0x7f, 0x2a, 0x91, 0x40, 0xc0, 0x80, 0x80, 0x48, 0x30, 0xf0, 0xd8, 0x00, 0x00,
+	0xd8, 0x70, 0x70, 0xc8, 0x80, 0x80, 0xc0, 0x40, 0x6d, 0x90, 0x22, 0x42, 0x81, 0x43, 0x22, 0x26,
+	0x34, 0xff, 0x3e, 0x3e, 0xff, 0x24, 0x26, 0x62, 0xc3, 0xc1, 0x62, 0x6f, 0x8f, 0x01, 0x00, 0x01,
+	0x0b, 0x06, 0x07, 0x09, 0x00, 0x00, 0x09, 0x07, 0x0e, 0x09, 0x01, 0x00, 0x01, 0x0a, 0x84, 0x00,
+	0xc0, 0x60, 0x20, 0x30, 0xc3, 0x38, 0x68, 0x81, 0x80, 0x80, 0xcc, 0x00, 0x70, 0x86, 0x01, 0x03,
+	0x0e, 0x18, 0xf0, 0xe0, 0x00, 0x7d, 0x83, 0x00, 0x00, 0x01, 0x00, 0x7f, 0x3d, 0x7f, 0x2b, 0x90,
+	0x80, 0x00, 0xc0, 0x58, 0x70, 0x38, 0x58, 0x00, 0x88, 0x50, 0x20, 0x78, 0xc8, 0x80, 0x00, 0x40,
+	0x00, 0x6d, 0x8e, 0x24, 0x42, 0xc1, 0xe2, 0x22, 0x00, 0x02, 0x24, 0x18, 0x1c, 0x34, 0x00, 0x00,
+	0x62, 0xc2, 0x75, 0x88, 0x0c, 0x07, 0x0d, 0x00, 0x10, 0x0b, 0x06, 0x0f, 0x0d, 0x0e, 0x89, 0x40,
+	0x70, 0x74, 0x3a, 0xfe, 0xff, 0xfc, 0xfe, 0x78, 0x54, 0x65, 0xc3, 0xc0, 0x10, 0x80, 0x01, 0x69,
+	0x83, 0x03, 0x03, 0x07, 0x03, 0xc2, 0x00, 0x7f, 0x00, 0x80, 0x00, 0x7f, 0x3e, 0x7f, 0x2a, 0x90,
+	0x00, 0x00, 0x30, 0x84, 0x40, 0x00, 0x04, 0x00, 0xa0, 0xa4, 0x00, 0x82, 0x00, 0xc0, 0x20, 0x30,
+	0x00, 0x6c, 0x94, 0x81, 0x10, 0x04, 0x00, 0x08, 0x80, 0x81, 0xb9, 0x4a, 0x00, 0xc0, 0x81, 0x00,
+	0x93, 0x1c, 0x00, 0x00, 0x10, 0x00, 0x05, 0x81, 0x0c, 0x86, 0x80, 0x00, 0xa0, 0x00, 0x00, 0x80,
+	0x40, 0x59, 0x8f, 0x00, 0x06, 0x10, 0x03, 0x30, 0x40, 0x00, 0x14, 0x14, 0x00, 0x30, 0x02, 0x02,
+	0x04, 0x06, 0x00, 0x0b, 0x8b, 0x90, 0xd4, 0x54, 0x39, 0xfe, 0xff, 0xfc, 0xfe, 0x69, 0x54, 0xd4,
+	0x10, 0x61, 0x87, 0xb0, 0x20, 0x80, 0xd0, 0xc0, 0xa0, 0x30, 0x90, 0x0c, 0x85, 0x03, 0x00, 0x07,
+	0x00, 0x00, 0x03, 0x64, 0x87, 0x09, 0x04, 0x01, 0x03, 0x03, 0x01, 0x05, 0x0c, 0x7f, 0x7f, 0x41,
+	0x7f, 0x2c, 0x80, 0x10, 0xc4, 0x00, 0x80, 0x80, 0xc5, 0x00, 0x80, 0x10, 0x6d, 0x80, 0x01, 0xc2,
+	0x00, 0x84, 0x08, 0x00, 0x00, 0x08, 0x40, 0xc3, 0x00, 0x80, 0x43, 0xc6, 0x00, 0x0e, 0x80, 0x80,
+	0x5e, 0x80, 0x04, 0xc7, 0x00, 0x80, 0x20, 0xc3, 0x00, 0x0d, 0x89, 0x54, 0x54, 0x39, 0xfe, 0xff,
+	0xfc, 0xfe, 0x69, 0x54, 0x94, 0x5f, 0x8c, 0x80, 0x88, 0x6c, 0x10, 0x00, 0x18, 0x00, 0x16, 0x18,
+	0x00, 0x50, 0x6c, 0x80, 0x0c, 0x80, 0x0b, 0x65, 0x8c, 0x10, 0x12, 0x09, 0x11, 0x18, 0x64, 0x08,
+	0x18, 0x01, 0x0b, 0x12, 0x11, 0x01, 0x7f, 0x7f, 0x3e, 0x7f, 0x2c, 0xcd, 0x00, 0x6d, 0xcd, 0x00,
+	0x12, 0x87, 0x60, 0x80, 0x00, 0xf0, 0x00, 0x00, 0x80, 0x60, 0x5a, 0xc9, 0x00, 0x0d, 0x91, 0x10,
+	0x10, 0x92, 0x92, 0x54, 0x54, 0x39, 0xfe, 0xff, 0xfc, 0xfe, 0x79, 0x54, 0xd4, 0x92, 0x13, 0x10,
+	0x10, 0x5a, 0x8e, 0x80, 0xc0, 0xcc, 0x9c, 0x08, 0x00, 0x10, 0x06, 0x0e, 0x16, 0x00, 0x08, 0x1c,
+	0x8c, 0x80, 0xc8, 0x00, 0x8a, 0x0c, 0x03, 0x00, 0x1f, 0x00, 0x00, 0x06, 0x0c, 0x00, 0x00, 0x01,
+	0x5d, 0x8e, 0x01, 0x31, 0x38, 0x10, 0x00, 0x60, 0xf0, 0x60, 0x08, 0x00, 0x10, 0x39, 0x13, 0x03,
+	0x01, 0x7f, 0x7f, 0x3d, 0x7f, 0x7f, 0x49, 0x80, 0xe0, 0x7f, 0x8b, 0x79, 0xfa, 0xff, 0xfc, 0xfe,
+	0x79, 0x54, 0xd4, 0x92, 0x13, 0x10, 0x00, 0x5a, 0x83, 0x00, 0x80, 0xc8, 0x1c, 0xc2, 0x00, 0x81,
+	0x06, 0x06, 0xc2, 0x00, 0x81, 0x0c, 0x88, 0x0f, 0x80, 0x07, 0x61, 0x86, 0x00, 0x10, 0x30, 0x10,
+	0x00, 0x00, 0x60, 0xc2, 0x00, 0x84, 0x10, 0x30, 0x11, 0x01, 0x00, 0x7f, 0x7f, 0x3d, 0x7f, 0x7f,
+	0x49, 0x80, 0x60, 0xc4, 0x00, 0x81, 0x80, 0x40, 0x74, 0x8c, 0x10, 0x92, 0x54, 0x54, 0x19, 0xbe,
+	0xed, 0xee, 0xba, 0x59, 0x54, 0x90, 0x92, 0xc2, 0x10, 0x5a, 0x83, 0x80, 0x80, 0x04, 0x08, 0xc3,
+	0x00, 0x85, 0x03, 0x00, 0x20, 0x00, 0x00, 0x04, 0xc9, 0x00, 0x86, 0x08, 0x03, 0x00, 0x0f, 0x00,
+	0x00, 0x03, 0x62, 0x8b, 0x21, 0x00, 0x00, 0x04, 0x00, 0x40, 0x00, 0x00, 0x04, 0x00, 0x10, 0x21,
+	0x7d, 0x82, 0x2c, 0xfc, 0xf0, 0x7d, 0x82, 0xf1, 0xff, 0x8f, 0x3d, 0x7f, 0x7f, 0x49, 0x84, 0x40,
+	0x00, 0x00, 0xe0, 0xe0, 0xc2, 0x00, 0x72, 0x91, 0x00, 0x10, 0x13, 0x10, 0x5c, 0x4c, 0x01, 0x02,
+	0x81, 0x80, 0x83, 0x21, 0x54, 0x14, 0x10, 0x13, 0x10, 0x00, 0x5a, 0x84, 0x00, 0x80, 0x04, 0x00,
+	0x10, 0xc2, 0x00, 0x86, 0x02, 0x00, 0x60, 0xf0, 0xe0, 0x84, 0x80, 0xc5, 0x00, 0x8a, 0x01, 0x00,
+	0x00, 0x04, 0x01, 0x00, 0x0e, 0x0e, 0x01, 0x00, 0x04, 0x61, 0x80, 0x20, 0xc3, 0x00, 0x80, 0x40,
+	0xc2, 0x00, 0x83, 0xe9, 0xff, 0x3f, 0x00, 0x7b, 0x83, 0x01, 0x0f, 0x3c, 0x00, 0x7d, 0x82, 0x80,
+	0x81, 0x80, 0x3d
+};
+
+#endif
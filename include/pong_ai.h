@@ -0,0 +1,41 @@
+#ifndef PONG_AI_H
+#define PONG_AI_H
+
+#include <stdint.h>
+
+// CPU paddle player. It works out where the ball will cross its paddle face (walls
+// included) whenever the ball's course changes at a paddle or a serve, then spends every
+// tick just walking towards that target.
+//
+// Difficulty is a level from 0 (easiest) to AI_MAX_LEVEL, which sets:
+//   - reaction delay: ticks before it starts moving after the ball changes course
+//   - max speed: paddle pixels per tick (8.8, at most one pixel per tick)
+//   - aim error: largest random offset (pixels) added to the target
+#define AI_MAX_LEVEL 42
+
+struct PongAI
+{
+    uint8_t level;
+    uint8_t reaction;       // Reaction delay (ticks)
+    uint16_t speed;         // Max paddle speed (pixels per tick, 8.8)
+    uint8_t aim_error;      // Largest aim error (pixels)
+
+    uint8_t target_y;       // Paddle top it is heading for
+    uint8_t wait;           // Ticks left before it reacts
+    uint16_t travel;        // Sub-pixel movement accumulated towards the next pixel (8.8)
+};
+
+struct PongState;
+
+// Set the difficulty level (clamped to AI_MAX_LEVEL) and stop any movement
+void aiSetLevel(PongAI &ai, uint8_t level);
+
+// Pick a new target for the current ball course: the predicted intercept plus aim error
+// while the ball comes towards the CPU, the middle of the court while it moves away.
+// Restarts the reaction delay.
+void aiPlan(PongState &state);
+
+// Move the CPU paddle one tick towards its target
+void aiStep(PongState &state);
+
+#endif
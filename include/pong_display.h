@@ -0,0 +1,214 @@
+#ifndef PONG_DISPLAY_H
+#define PONG_DISPLAY_H
+
+#include <Arduino.h>
+#include <pong_panel.h>
+#include <pong_scene.h>
+#include <pong_sim.h>
+#include <pong_twi.h>
+
+// Panel bus, chosen at build time (src/main.cpp and bench/ construct the display to match):
+// 0 = I2C, 1 = 4-wire hardware SPI (MOSI 11, SCK 13, plus the pins below). Both send the
+// panel the same command and data bytes.
+#ifndef PONG_DISPLAY_SPI
+#define PONG_DISPLAY_SPI    0
+#endif
+#define OLED_DC             9
+#define OLED_CS             10
+
+// Renderer, chosen at build time: 0 = a RAM buffer of the whole panel (1 KB at 128x64) that
+// items are painted into, 1 = no buffer: screens are a display list (pong_scene.h) that
+// every flush rasterizes span by span into the snapshot below as it sends them
+#ifndef PONG_PAGE_RENDER
+#define PONG_PAGE_RENDER    0
+#endif
+
+// Dirty region granularity: the panel is split into SSD1306 pages (8 pixel rows each),
+// and each page into blocks of 4 columns. One bit per block marks it for the next flush.
+#define DIRTY_BLOCK_SHIFT       2   // log2(columns per block)
+#define DIRTY_BLOCK_COLUMNS     (1 << DIRTY_BLOCK_SHIFT)
+#define DIRTY_BLOCKS_PER_PAGE   (128 >> DIRTY_BLOCK_SHIFT)  // Widest SSD1306 panel
+#define DIRTY_MASK_BYTES        (DIRTY_BLOCKS_PER_PAGE / 8)
+
+// Clean blocks between two dirty runs are resent instead of opening a new address window
+// when this is cheaper on the bus (a new window costs ~10 bytes of commands and headers)
+#define DIRTY_MERGE_GAP_BLOCKS  2
+
+// Snapshot space for asynchronous flushes: window commands plus pixel bytes. Larger dirty
+// regions are flushed synchronously instead. The page renderer also rasterizes into it,
+// so it holds at least one full page.
+#define PONG_SNAPSHOT_BYTES     144
+
+// Position of a walk over the dirty runs, see Display::nextDirtyRun()
+struct DirtyCursor
+{
+    uint8_t page;
+    uint8_t block;
+};
+
+// SSD1306 display that remembers which parts of the panel changed since the last flush, so
+// the game loop can push only those bytes instead of the whole panel. The panel size and
+// bus (PanelI2C or PanelSPI, pong_panel.h) are template arguments: nothing is virtual, and
+// the coordinate math folds into constants. The game uses PongDisplay below, whose members
+// are compiled once in pong_display.cpp.
+template <uint8_t W, uint8_t H, class Transport>
+class Display
+{
+public:
+    static const uint8_t WIDTH = W;
+    static const uint8_t HEIGHT = H;
+    static const uint8_t PAGES = H / 8;
+
+    static_assert(W <= 128 && (H == 32 || H == 64), "SSD1306 panels are up to 128 columns by 32 or 64 rows");
+
+    explicit Display(const Transport &bus);
+
+    // Start the bus and the panel ('address' 0 picks the SSD1306 default for the height)
+    void begin(uint8_t vcs = SSD1306_SWITCHCAPVCC, uint8_t address = 0);
+
+    // Put an item on top of the screen. The RAM buffer renderer paints it right away and
+    // returns SCENE_ITEMS; the page renderer adds it to the display list and returns its
+    // slot, or SCENE_ITEMS if the list is full.
+    uint8_t addItem(const SceneItem &item);
+
+#if PONG_PAGE_RENDER
+    // Move an item; only the boxes it left and entered are sent by the next flush (for a
+    // fill that keeps its column, only the pages whose rows changed)
+    void moveItem(uint8_t slot, int16_t x, int16_t y);
+#else
+    // Page-native rally primitives: write the RAM buffer directly in SSD1306 page layout,
+    // without clipping (on-screen columns), and mark only the bytes whose value changes.
+
+    // Move a 'length' pixel vertical line in column x from row from_y to row to_y, rewriting
+    // each page byte it covers once (from_y == to_y draws it in place)
+    inline void moveColumn(uint8_t x, uint8_t from_y, uint8_t to_y, uint8_t length);
+    // Set or clear one pixel (off-screen pixels are ignored)
+    inline void setPixelBit(uint8_t x, uint8_t y, bool on);
+
+    // The RAM buffer in SSD1306 page layout (page * WIDTH + column); writes are not tracked
+    uint8_t *getBuffer() { return buffer; }
+#endif
+
+    // Blank screen (everything dirty)
+    void clearDisplay();
+    // Send the whole screen
+    void display();
+
+    // Send only the dirty column ranges of each page, then mark everything clean
+    void flushDirty();
+
+    // Copy the dirty column ranges into a snapshot and return right away, while pong_twi
+    // sends them in the background (its interrupt, or polling twiService() calls). Drawing can continue
+    // immediately. Returns false, leaving the dirty marks for next time, while the previous
+    // flush is still on the bus.
+    bool flushAsync();
+
+    void markAllDirty();
+    void clearDirty();
+
+    // Direct panel writes that bypass the screen (which is marked dirty afterwards, as it no
+    // longer matches the panel). Wrap runs in beginPanelWrite()/endPanelWrite().
+    void beginPanelWrite();
+    // Write 'length' bytes from PROGMEM at page buffer offset 'offset' (page * WIDTH + column),
+    // without crossing a page; 'repeat' sends the single byte at 'data' 'length' times
+    void writePanel_P(uint16_t offset, const uint8_t *data, uint8_t length, bool repeat);
+    void endPanelWrite();
+
+private:
+    void markDirty(int16_t x0, int16_t x1, int16_t page);
+    void markBox(int16_t x, int16_t y, uint8_t w, uint8_t h);
+    inline void markBlock(uint8_t x, uint8_t page);
+    bool nextDirtyRun(DirtyCursor &cursor, uint8_t &page, uint8_t &col_start, uint8_t &col_end);
+    const uint8_t *spanPixels(uint8_t page, uint8_t col_start, uint8_t col_end, uint8_t *scratch);
+    void sendWindow(uint8_t page, uint8_t col_start, uint8_t col_end);
+
+    // flushAsync() by bus: I2C queues the snapshot on pong_twi, SPI is fast enough to flush
+    // in place
+    bool flushQueued(PanelI2C &i2c);
+    bool flushQueued(PanelSPI &spi);
+
+    Transport bus;
+    uint8_t dirty[PAGES][DIRTY_MASK_BYTES];
+    uint8_t snapshot[PONG_SNAPSHOT_BYTES];
+    uint16_t twi_errors;
+#if PONG_PAGE_RENDER
+    SceneItem items[SCENE_ITEMS];
+    uint8_t item_count;
+#else
+    uint8_t buffer[W * PAGES];
+#endif
+};
+
+// The game's display. SCREEN_WIDTH and SCREEN_HEIGHT (pong_sim.h) size the court and UI
+// layout too, so a 128x32 panel is one build flag: -DSCREEN_HEIGHT=32.
+#if PONG_DISPLAY_SPI
+typedef PanelSPI PongBus;
+#else
+typedef PanelI2C PongBus;
+#endif
+typedef Display<SCREEN_WIDTH, SCREEN_HEIGHT, PongBus> PongDisplay;
+
+extern template class Display<SCREEN_WIDTH, SCREEN_HEIGHT, PongBus>;
+
+template <uint8_t W, uint8_t H, class Transport>
+const uint8_t Display<W, H, Transport>::WIDTH;
+template <uint8_t W, uint8_t H, class Transport>
+const uint8_t Display<W, H, Transport>::HEIGHT;
+template <uint8_t W, uint8_t H, class Transport>
+const uint8_t Display<W, H, Transport>::PAGES;
+
+// Rows y..y+length-1 that fall in 'page', as a page byte
+static inline uint8_t columnMask(uint8_t page, uint8_t y, uint8_t length)
+{
+    int16_t top = (int16_t)y - page * 8;
+    int16_t bottom = top + length - 1;
+    if (bottom < 0 || top > 7) return 0;
+
+    uint8_t mask = 0xFF;
+    if (top > 0) mask <<= top;
+    if (bottom < 7) mask &= 0xFF >> (7 - bottom);
+    return mask;
+}
+
+template <uint8_t W, uint8_t H, class Transport>
+inline void Display<W, H, Transport>::markBlock(uint8_t x, uint8_t page)
+{
+    uint8_t block = x >> DIRTY_BLOCK_SHIFT;
+    dirty[page][block >> 3] |= 1 << (block & 7);
+}
+
+#if !PONG_PAGE_RENDER
+
+template <uint8_t W, uint8_t H, class Transport>
+inline void Display<W, H, Transport>::moveColumn(uint8_t x, uint8_t from_y, uint8_t to_y, uint8_t length)
+{
+    uint8_t first = (from_y < to_y ? from_y : to_y) >> 3;
+    uint8_t last = ((from_y > to_y ? from_y : to_y) + length - 1) >> 3;
+    if (last >= PAGES) last = PAGES - 1;
+
+    uint8_t *byte = buffer + first * W + x;
+    for (uint8_t page = first; page <= last; page++, byte += W)
+    {
+        uint8_t value = (*byte & ~columnMask(page, from_y, length)) | columnMask(page, to_y, length);
+        if (value == *byte) continue;
+        *byte = value;
+        markBlock(x, page);
+    }
+}
+
+template <uint8_t W, uint8_t H, class Transport>
+inline void Display<W, H, Transport>::setPixelBit(uint8_t x, uint8_t y, bool on)
+{
+    if (x >= W || y >= H) return;
+
+    uint8_t *byte = buffer + (y >> 3) * W + x;
+    uint8_t bit = 1 << (y & 7);
+    uint8_t value = on ? *byte | bit : *byte & ~bit;
+    if (value == *byte) return;
+    *byte = value;
+    markBlock(x, y >> 3);
+}
+
+#endif
+
+#endif
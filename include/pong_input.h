@@ -0,0 +1,49 @@
+#ifndef PONG_INPUT_H
+#define PONG_INPUT_H
+
+#include <Arduino.h>
+
+// Pin definitions (active low). Both must stay on port D (PD6/PD7), which is what the
+// PCINT2 pin change interrupt watches.
+#define UP_BUTTON       6
+#define DOWN_BUTTON     7
+
+// Button bits in event and held masks
+#define INPUT_UP        0x01
+#define INPUT_DOWN      0x02
+
+// Level changes closer than this to the last accepted change of the same button are contact
+// bounce; the level is checked again once the window has passed (ms)
+#define INPUT_DEBOUNCE_MS   5
+
+// Queued events (power of two). When full, new events are dropped; the held mask stays right.
+#define INPUT_QUEUE_SIZE    8
+
+// Debounced press or release of one button, stamped with millis() in the interrupt
+struct InputEvent
+{
+    unsigned long time;
+    uint8_t button;     // INPUT_UP or INPUT_DOWN
+    bool pressed;
+};
+
+// Configure the button pins and enable their pin change interrupt
+void inputBegin();
+
+// Take the oldest queued event, returns false when the queue is empty.
+// Only the main loop may call this (single consumer).
+bool inputPop(InputEvent &event);
+
+// Debounced buttons currently held down (INPUT_UP | INPUT_DOWN)
+uint8_t inputHeld();
+
+// Resolve changes that arrived inside a debounce window once it has passed. Cheap when
+// nothing is pending; call before draining the queue, at least once per debounce window.
+void inputService(unsigned long time);
+
+// True when no event is queued, no button is held and no bounce is waiting to settle, i.e.
+// only a pin change can bring news. Call with interrupts disabled before powering down, so
+// a change cannot slip in between.
+bool inputIdle();
+
+#endif
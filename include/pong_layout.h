@@ -0,0 +1,71 @@
+#ifndef PONG_LAYOUT_H
+#define PONG_LAYOUT_H
+
+#include <Arduino.h>
+#include <pong_sim.h>
+#include <pong_text.h>
+
+// The layout tables below are computed at compile time for the screen size in pong_sim.h
+
+// Fixed UI string with its cursor position and text bounds (what getTextBounds() would report)
+struct UiText
+{
+    const char *text;   // PROGMEM
+    int16_t x, y;
+    uint16_t w, h;
+    uint8_t size;
+};
+
+struct UiRect
+{
+    int16_t x, y;
+    uint16_t w, h;
+};
+
+// Every fixed string drawn on the menu and banners
+enum UiTextId : uint8_t
+{
+    UI_PLAY,
+    UI_PRESS_ANY_BUTTON,
+    UI_CPU_SCORES,
+    UI_PLAYER_SCORES,
+    UI_CPU_WINS,
+    UI_PLAYER_WINS,
+    UI_TEXT_COUNT
+};
+
+// Every fixed box drawn around UI text
+enum UiRectId : uint8_t
+{
+    UI_PLAY_BOX,
+    UI_RECT_COUNT
+};
+
+// Row that vertically centers one line of text of the given size
+constexpr int16_t textCenterY(uint8_t size)
+{
+    return ((int16_t)SCREEN_HEIGHT - (int16_t)textHeight(size)) / 2;
+}
+
+// Layout of 'length' characters horizontally centered at row 'y'
+constexpr UiText centeredText(const char *text, uint8_t length, uint8_t size, int16_t y)
+{
+    return UiText{ text, textCenterX(SCREEN_WIDTH, length, size), y, textWidth(length, size), textHeight(size), size };
+}
+
+// Box 'margin' pixels outside a text layout
+constexpr UiRect boxAround(const UiText &text, uint8_t margin)
+{
+    return UiRect{ (int16_t)(text.x - margin), (int16_t)(text.y - margin), (uint16_t)(text.w + 2 * margin), (uint16_t)(text.h + 2 * margin) };
+}
+
+// Rows of the banner lines
+const int16_t UI_BANNER_Y =     textCenterY(1);
+const int16_t UI_HEADLINE_Y =   UI_BANNER_Y - 10;
+const int16_t UI_SCOREBOARD_Y = UI_BANNER_Y + 8;
+
+// Tables in PROGMEM, indexed by UiTextId / UiRectId (pong_scene.h turns them into items)
+extern const UiText ui_text[UI_TEXT_COUNT] PROGMEM;
+extern const UiRect ui_rect[UI_RECT_COUNT] PROGMEM;
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef PONG_PANEL_H
+#define PONG_PANEL_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <Wire.h>
+#include <pong_twi.h>
+
+// SSD1306 buses. The panel sees the same command and data bytes over either one: I2C
+// prefixes each transaction with a control byte, SPI holds data/command low or high. The
+// SSD1306 side (power-up settings, address windows) is written once in PanelBus and reaches
+// each bus's sendCommands() through CRTP, so nothing is virtual.
+
+// SSD1306 commands the game sends
+#define SSD1306_MEMORYMODE          0x20
+#define SSD1306_COLUMNADDR          0x21
+#define SSD1306_PAGEADDR            0x22
+#define SSD1306_DEACTIVATE_SCROLL   0x2E
+#define SSD1306_SETSTARTLINE        0x40
+#define SSD1306_SETCONTRAST         0x81
+#define SSD1306_CHARGEPUMP          0x8D
+#define SSD1306_SEGREMAP            0xA0
+#define SSD1306_DISPLAYALLON_RESUME 0xA4
+#define SSD1306_NORMALDISPLAY       0xA6
+#define SSD1306_SETMULTIPLEX        0xA8
+#define SSD1306_DISPLAYOFF          0xAE
+#define SSD1306_DISPLAYON           0xAF
+#define SSD1306_COMSCANDEC          0xC8
+#define SSD1306_SETDISPLAYOFFSET    0xD3
+#define SSD1306_SETDISPLAYCLOCKDIV  0xD5
+#define SSD1306_SETPRECHARGE        0xD9
+#define SSD1306_SETCOMPINS          0xDA
+#define SSD1306_SETVCOMDETECT       0xDB
+
+// Supply options for begin()
+#define SSD1306_EXTERNALVCC         0x01
+#define SSD1306_SWITCHCAPVCC        0x02
+
+// I2C control bytes
+#define SSD1306_CONTROL_COMMANDS    0x00
+#define SSD1306_CONTROL_DATA        0x40
+
+// PAGEADDR and COLUMNADDR with their arguments
+#define PANEL_WINDOW_BYTES          6
+
+// Panel data sources (same values as the pong_twi transaction flags)
+#define PANEL_PROGMEM       TWI_PROGMEM
+#define PANEL_REPEAT        TWI_REPEAT
+
+// Wire clock while the panel is written and after (PONG_TWI_TRANSPORT 0 only, pong_twi
+// sets its own), same as Adafruit_SSD1306
+#define PANEL_WIRE_CLOCK        400000UL
+#define PANEL_WIRE_IDLE_CLOCK   100000UL
+
+// SPI clock
+#define PONG_SPI_CLOCK      8000000UL
+
+template <class Bus>
+class PanelBus
+{
+public:
+    // Pulse the reset line (if there is one), then send the settings Adafruit_SSD1306::begin()
+    // sends, in one go
+    void start(uint8_t width, uint8_t height, uint8_t vcs)
+    {
+        if (rst_pin >= 0)
+        {
+            pinMode(rst_pin, OUTPUT);
+            digitalWrite(rst_pin, HIGH);
+            delay(1);
+            digitalWrite(rst_pin, LOW);
+            delay(10);
+            digitalWrite(rst_pin, HIGH);
+        }
+
+        const bool external = vcs == SSD1306_EXTERNALVCC;
+        const bool tall = width == 128 && height == 64;
+        const uint8_t init[] =
+        {
+            SSD1306_DISPLAYOFF,
+            SSD1306_SETDISPLAYCLOCKDIV, 0x80,
+            SSD1306_SETMULTIPLEX, (uint8_t)(height - 1),
+            SSD1306_SETDISPLAYOFFSET, 0x00,
+            SSD1306_SETSTARTLINE | 0x00,
+            SSD1306_CHARGEPUMP, (uint8_t)(external ? 0x10 : 0x14),
+            SSD1306_MEMORYMODE, 0x00,
+            SSD1306_SEGREMAP | 0x01,
+            SSD1306_COMSCANDEC,
+            SSD1306_SETCOMPINS, (uint8_t)(tall ? 0x12 : 0x02),
+            SSD1306_SETCONTRAST, (uint8_t)(tall ? (external ? 0x9F : 0xCF) : 0x8F),
+            SSD1306_SETPRECHARGE, (uint8_t)(external ? 0x22 : 0xF1),
+            SSD1306_SETVCOMDETECT, 0x40,
+            SSD1306_DISPLAYALLON_RESUME,
+            SSD1306_NORMALDISPLAY,
+            SSD1306_DEACTIVATE_SCROLL,
+            SSD1306_DISPLAYON
+        };
+        bus().sendCommands(init, sizeof(init));
+    }
+
+    // Point the SSD1306 address window at a range of pages and columns
+    void setWindow(uint8_t page_start, uint8_t page_end, uint8_t col_start, uint8_t col_end)
+    {
+        const uint8_t commands[PANEL_WINDOW_BYTES] =
+        {
+            SSD1306_PAGEADDR, page_start, page_end, SSD1306_COLUMNADDR, col_start, col_end
+        };
+        bus().sendCommands(commands, sizeof(commands));
+    }
+
+protected:
+    explicit PanelBus(int8_t rst_pin) : rst_pin(rst_pin) {}
+
+    int8_t rst_pin;
+
+private:
+    Bus &bus() { return static_cast<Bus &>(*this); }
+};
+
+// Panel on the I2C bus: synchronous writes go through pong_twi (PONG_TWI_TRANSPORT 1) or
+// Wire in 32-byte chunks, and the address is what flushAsync() queues transactions for
+class PanelI2C : public PanelBus<PanelI2C>
+{
+public:
+    explicit PanelI2C(int8_t rst_pin) : PanelBus<PanelI2C>(rst_pin), i2c_address(0) {}
+
+    void begin(uint8_t address);
+    uint8_t address() const { return i2c_address; }
+
+    // Around runs of synchronous writes
+    void beginWrite();
+    void endWrite();
+
+    void sendCommands(const uint8_t *commands, uint8_t length);
+    // Send 'length' data bytes from RAM, or PROGMEM with PANEL_PROGMEM; PANEL_REPEAT sends
+    // the byte at 'data' 'length' times
+    void sendData(const uint8_t *data, uint8_t length, uint8_t flags);
+
+private:
+    uint8_t i2c_address;
+};
+
+// Panel on 4-wire hardware SPI (MOSI 11, SCK 13, plus data/command and chip select)
+class PanelSPI : public PanelBus<PanelSPI>
+{
+public:
+    PanelSPI(int8_t dc_pin, int8_t rst_pin, int8_t cs_pin)
+        : PanelBus<PanelSPI>(rst_pin), dc_pin(dc_pin), cs_pin(cs_pin), settings(PONG_SPI_CLOCK, MSBFIRST, SPI_MODE0)
+    {
+    }
+
+    // SPI panels have no address
+    void begin(uint8_t address);
+
+    void beginWrite() {}
+    void endWrite() {}
+
+    void sendCommands(const uint8_t *commands, uint8_t length);
+    void sendData(const uint8_t *data, uint8_t length, uint8_t flags);
+
+private:
+    void select(bool data);
+    void deselect();
+
+    int8_t dc_pin, cs_pin;
+    SPISettings settings;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef PONG_RECORD_H
+#define PONG_RECORD_H
+
+#include <Arduino.h>
+#include <pong_sim.h>
+
+// Match recorder and replayer. The simulation is deterministic, so a trace only needs a
+// starting state and the inputs of every tick after it. Inputs are delta coded, one byte
+// per change:
+//   bits 0-1  buttons (INPUT_UP | INPUT_DOWN) from now on
+//   bits 2-7  ticks the previous buttons lasted before the change (0..62); 63 means 63
+//             ticks without a change (the button bits repeat the current ones)
+// The bytes live in a ring of RECORD_EVENTS: once it is three quarters full, the oldest
+// bytes are stepped into the starting state and dropped a couple of ticks at a time, so a
+// trace holds the latest part of a match. Inputs changing on most ticks for a while outrun
+// that; the trace then starts over from the current tick.
+//
+// Traces are saved to EEPROM at the end of every match, one byte per recordService() call
+// so no pass waits on an EEPROM write, and can be printed as hex over Serial. The state is
+// stored field by field in little endian, so a trace dumped from the Uno replays on the
+// native build. Build with -DPONG_RECORD=0 to remove the recorder.
+#ifndef PONG_RECORD
+#define PONG_RECORD 1
+#endif
+
+// Input changes kept (the oldest part of a long match is dropped first)
+#ifndef RECORD_EVENTS
+#define RECORD_EVENTS           64
+#endif
+
+// Where the trace lives in EEPROM
+#define RECORD_EEPROM_ADDRESS   0
+
+#if PONG_RECORD
+
+// Start recording a match from 'state' (right after pongReset())
+void recordBegin(const PongState &state);
+
+// Log the inputs of the tick about to be stepped from 'state'
+void recordTick(const PongState &state, const PongInputs &inputs);
+
+// Start storing the trace, ending at 'state', in EEPROM (only the bytes that changed are
+// written). recordBegin() and replayBegin() finish a save still in progress first.
+void recordSave(const PongState &state);
+
+// Write the next byte of a save once the EEPROM is ready for it (call at least 3.4 ms apart
+// to never find it busy). Returns true while the save is in progress.
+bool recordService();
+
+// Print the trace being recorded, ending at 'state', over Serial as hex (the EEPROM image)
+void recordDump(const PongState &state);
+
+// Load the trace saved in EEPROM and put its starting state in 'state'. Returns false, with
+// nothing changed, if there is none or it does not fit the ring. Recording stops until the
+// next recordBegin().
+bool replayBegin(PongState &state);
+
+// Inputs for the next tick; returns false once the trace is exhausted
+bool replayNext(PongInputs &inputs);
+
+// True if 'state' is where the recorded match was when the trace was saved
+bool replayMatches(const PongState &state);
+
+#else
+
+inline void recordBegin(const PongState &) {}
+inline void recordTick(const PongState &, const PongInputs &) {}
+inline void recordSave(const PongState &) {}
+inline bool recordService() { return false; }
+inline void recordDump(const PongState &) {}
+inline bool replayBegin(PongState &) { return false; }
+inline bool replayNext(PongInputs &) { return false; }
+inline bool replayMatches(const PongState &) { return false; }
+
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef PONG_RENDER_H
+#define PONG_RENDER_H
+
+#include <Arduino.h>
+#include <pong_display.h>
+#include <pong_layout.h>
+#include <pong_sim.h>
+
+// Every screen of the game, drawn into the display (nothing is flushed). Shared by the
+// game, bench/ and tools/golden, which checks the screens of both renderers against each
+// other and rally frames against a full redraw. Screens are built from scene items, which
+// the RAM buffer (PONG_PAGE_RENDER 0) paints right away and the page renderer keeps in its
+// display list; rally frames use each renderer's own incremental primitives.
+
+// Rally screen, drawn incrementally: each frame erases the ball and paddles where they were
+// last drawn and draws them where the simulation put them
+struct RallyView
+{
+    PongState drawn;    // State the buffer shows
+    bool valid;         // False until the first frame after drawCourt()
+};
+
+// Empty court: clear the screen and draw the border, the next drawRally() draws everything
+void drawCourt(PongDisplay &display, RallyView &view);
+
+// Bring the screen from view.drawn to 'state'
+void drawRally(PongDisplay &display, RallyView &view, const PongState &state);
+
+// Main menu, and the play button flash when a button is pressed on it
+void drawMenu(PongDisplay &display);
+void drawMenuPress(PongDisplay &display);
+
+// Goal headline and scoreboard over the court
+void drawGoalBanner(PongDisplay &display, UiTextId headline, uint8_t cpu_score, uint8_t player_score);
+
+// Match winner on an empty court
+void drawVictoryBanner(PongDisplay &display, UiTextId headline);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef PONG_SCENE_H
+#define PONG_SCENE_H
+
+#include <Arduino.h>
+#include <pong_layout.h>
+
+// Screens as lists of boxes, lines and text lines, painted in order, later items on top.
+// The RAM buffer renderer paints each item into its buffer as it is added; the page renderer
+// (PONG_PAGE_RENDER in pong_display.h) keeps the list instead of a 1 KB image of the panel
+// and rasterizes any page span from it when it is sent. Text uses the classic 5x7 Adafruit
+// GFX font, so screens look exactly the same as when drawn with Adafruit_GFX.
+
+// Item colors (same values as Adafruit_SSD1306)
+#define BLACK       0
+#define WHITE       1
+#define INVERSE     2
+
+// Most items on screen at once (the goal banner over a rally uses 7)
+#define SCENE_ITEMS     8
+
+enum SceneKind : uint8_t
+{
+    SCENE_FILL,         // Solid box (pixels and lines too)
+    SCENE_RECT,         // One pixel outline
+    SCENE_TEXT,         // Transparent text from RAM, which must outlive the item
+    SCENE_TEXT_P        // Transparent text from PROGMEM
+};
+
+struct SceneItem
+{
+    SceneKind kind;
+    uint8_t color;      // WHITE, BLACK or INVERSE
+    int16_t x, y;       // Top left corner (text: cursor position)
+    uint8_t w, h;       // Box size (text: length * 6 * size by 8 * size)
+    uint8_t size;       // Text size
+    const char *text;
+};
+
+// Item constructors
+SceneItem sceneFill(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color);
+SceneItem sceneRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color);
+SceneItem sceneText(int16_t x, int16_t y, const char *text, uint8_t length, uint8_t size, uint8_t color);
+SceneItem sceneUiText(UiTextId id, uint8_t color);
+SceneItem sceneUiRect(UiRectId id, bool filled, uint8_t color);
+
+// Paint one item over columns col_start..col_end (inclusive) of one page in 'out', one byte
+// per column in SSD1306 layout (bit 0 is the top row of the page)
+void scenePaint(const SceneItem &item, uint8_t page, uint8_t col_start, uint8_t col_end, uint8_t *out);
+
+// Same for a whole list, over a blank span
+void sceneRender(const SceneItem *items, uint8_t count, uint8_t page, uint8_t col_start, uint8_t col_end,
+                 uint8_t *out);
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef PONG_SCHED_H
+#define PONG_SCHED_H
+
+#include <Arduino.h>
+
+// Cooperative task scheduler. Timer1 runs in CTC mode and its compare interrupt advances a
+// tick counter every SCHED_TICK_US; loop() reads it with schedNow() and runs each task whose
+// deadline has passed. Deadlines advance by whole periods from where they were, not from when
+// the task ran, so a late pass does not push every later deadline back with it.
+//
+// Between passes with nothing due, schedIdle() sleeps until the next tick, so deadlines are
+// met as before with the CPU mostly off; other interrupts, like a panel transfer's bytes,
+// only wake it for their handlers.
+//
+// Times are 16-bit and wrap every 16 s, far sooner than millis() does, so every comparison
+// goes through schedReached()/schedSince() and wrapping is exercised in every session
+// instead of after 49 days. Periods, delays and the time between two polls of a running task
+// must stay under half the range (8 s).
+
+// Scheduler clock period (us)
+#define SCHED_TICK_US   250
+
+typedef uint16_t SchedTime;
+
+// Scheduler ticks in 'ms' milliseconds
+#define SCHED_MS(ms)    ((SchedTime)((ms) * 1000UL / SCHED_TICK_US))
+
+// The game's tasks. The CPU player's AI runs inside each physics tick, so that replays and
+// tools/selfplay see the same simulation.
+enum SchedTaskId : uint8_t
+{
+    TASK_INPUT,     // Button events and held state
+    TASK_PHYSICS,   // Simulation ticks
+    TASK_RENDER,    // Rally frames, or fireworks frames on the victory screen
+    TASK_SERIAL,    // Telemetry and trace commands
+    TASK_RECORD,    // EEPROM writes of the trace saved at the end of a match
+    SCHED_TASKS
+};
+
+// Start Timer1 (it is the scheduler's from then on)
+void schedBegin();
+
+// Current scheduler time
+SchedTime schedNow();
+
+// Whether 'deadline' has passed at 'now'
+inline bool schedReached(SchedTime now, SchedTime deadline)
+{
+    return (int16_t)(now - deadline) >= 0;
+}
+
+// Time from 'since' to 'now'
+inline SchedTime schedSince(SchedTime now, SchedTime since)
+{
+    return now - since;
+}
+
+// (Re)start a task: first deadline at 'first', then one every 'period'
+void schedStart(SchedTaskId task, SchedTime period, SchedTime first);
+
+// Stop a task until it is started again (its deadlines no longer keep the CPU awake)
+void schedStop(SchedTaskId task);
+
+// Number of the task's deadlines that have passed at 'now', at most 'limit', all of which
+// the caller now runs (none while the task is stopped). Deadlines beyond the limit are
+// dropped as missed and the next one is a period from now. How late the first one ran goes
+// to the telemetry.
+uint8_t schedDue(SchedTaskId task, SchedTime now, uint8_t limit = 1);
+
+// Sleep (SLEEP_MODE_IDLE) until the next scheduler tick, unless a running task is already
+// due or a background panel transfer needs twiService() to start. Timers, TWI and Serial keep
+// running, their interrupts too.
+void schedIdle();
+
+// Power down until a button changes (pin change interrupt), unless input is already waiting
+// or a panel transfer is running. Every clock stops, so millis() and scheduler time stand
+// still meanwhile, and Serial input that arrives is lost. Running tasks start over from the
+// wake up time.
+void schedPowerDown();
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef PONG_SIM_H
+#define PONG_SIM_H
+
+#include <stdint.h>
+#include <pong_ai.h>
+
+// Tuning knobs. The defaults are the shipped game; a build can override them, e.g. to
+// compare balance with tools/selfplay (-DPONG_PADDLE_LENGTH=10)
+#ifndef PONG_PADDLE_LENGTH
+#define PONG_PADDLE_LENGTH      12
+#endif
+#ifndef PONG_BALL_SERVE_SPEED
+#define PONG_BALL_SERVE_SPEED   256     // Pixels per tick along x, 8.8
+#endif
+#ifndef PONG_BALL_MAX_SPEED
+#define PONG_BALL_MAX_SPEED     448     // Pixels per tick along x, 8.8
+#endif
+#ifndef PONG_BALL_SPEEDUP
+#define PONG_BALL_SPEEDUP       6       // Speed added per paddle hit, 8.8
+#endif
+
+// Panel size in pixels: a 128x64 SSD1306 by default, or a 128x32 one (-DSCREEN_HEIGHT=32).
+// The court fills the screen, and the display and UI layout are built for the same size.
+#ifndef SCREEN_WIDTH
+#define SCREEN_WIDTH    128
+#endif
+#ifndef SCREEN_HEIGHT
+#define SCREEN_HEIGHT    64
+#endif
+
+// Court geometry (pixels), shared by the simulation and the renderer
+const uint8_t COURT_WIDTH =     SCREEN_WIDTH;
+const uint8_t COURT_HEIGHT =    SCREEN_HEIGHT;
+const uint8_t PADDLE_LENGTH =    PONG_PADDLE_LENGTH; // Length of both paddles
+const uint8_t CPU_X =            12; // CPU paddle column
+const uint8_t PLAYER_X =        115; // Player paddle column
+const uint8_t PADDLE_START_Y =   16; // Paddle position after every serve
+
+// Half paddle length (constant)
+const uint8_t half_paddle = PADDLE_LENGTH / 2;
+
+// Ball positions and velocities are 8.8 fixed point: pixels in the high byte, 1/256 pixel
+// steps in the low byte, so the ball can move at any speed and angle without floats
+#define FIXED_SHIFT 8
+constexpr int16_t toFixed(int16_t pixels) { return pixels << FIXED_SHIFT; }
+constexpr int16_t toPixel(int16_t fixed) { return fixed >> FIXED_SHIFT; }
+
+// Ball speed along x (pixels per tick, 8.8). Every paddle hit speeds the ball up a little.
+const int16_t BALL_SERVE_SPEED =   PONG_BALL_SERVE_SPEED;  // 1 px/tick
+const int16_t BALL_SPEEDUP =       PONG_BALL_SPEEDUP;      // ~2% per hit
+const int16_t BALL_MAX_SPEED =     PONG_BALL_MAX_SPEED;    // 1.75 px/tick
+
+// Vertical slope added per pixel the ball hits away from the paddle center, so the edges
+// send it back at (almost) 45 degrees and the center straight across (8.8 per pixel)
+const int16_t DEFLECTION_STEP =    toFixed(1) / half_paddle;
+
+// The ball moves freely between these lines (8.8); it bounces off the walls and paddles
+// where it would cross them, and scores once it gets past a paddle and below BALL_MIN_X
+// or above BALL_MAX_X
+const int16_t BALL_MIN_X =         toFixed(1);
+const int16_t BALL_MAX_X =         toFixed(COURT_WIDTH - 2);
+const int16_t BALL_MIN_Y =         toFixed(1);
+const int16_t BALL_MAX_Y =         toFixed(COURT_HEIGHT - 2);
+const int16_t CPU_PADDLE_FACE =    toFixed(CPU_X + 1);
+const int16_t PLAYER_PADDLE_FACE = toFixed(PLAYER_X - 1);
+
+// Tick fractions used by the swept collision code (8.8: 256 = one whole tick)
+const uint16_t TICK_FRACTION =     toFixed(1);
+
+// Most bounces resolved within one sweep, enough for a corner hit at top speed
+#define MAX_CONTACTS 4
+
+// Player controls sampled for one tick
+struct PongInputs
+{
+    bool up;
+    bool down;
+};
+
+// What happened during a tick
+enum PongEvent : uint8_t
+{
+    EVENT_NONE = 0,
+    EVENT_PLAYER_GOAL,
+    EVENT_CPU_GOAL
+};
+
+// Surfaces the ball can bounce off
+enum PongSurface : uint8_t
+{
+    SURFACE_TOP_WALL,
+    SURFACE_BOTTOM_WALL,
+    SURFACE_CPU_PADDLE,
+    SURFACE_PLAYER_PADDLE
+};
+
+// One bounce found by pongSweepBall()
+struct PongContact
+{
+    PongSurface surface;
+    uint16_t time;          // Time of impact from the start of the sweep (tick fraction, 8.8)
+};
+
+// Complete simulation state: stepping the same state with the same inputs always
+// produces the same result, the random generator included
+struct PongState
+{
+    int16_t ball_x, ball_y;         // Ball position (8.8)
+    int16_t ball_vx, ball_vy;       // Ball velocity per tick (8.8)
+    int16_t ball_speed;             // Current speed along x (8.8), grows with every paddle hit
+    uint8_t cpu_y;                  // Top of the CPU paddle
+    uint8_t player_y;               // Top of the player paddle
+    PongAI ai;                      // CPU player and its difficulty
+    uint8_t cpu_score, player_score;
+    uint32_t rng;                   // xorshift32 state
+    uint32_t tick;                  // Ticks stepped since pongReset()
+};
+
+// Pixel the ball is drawn at
+inline uint8_t ballPixelX(const PongState &state) { return toPixel(state.ball_x); }
+inline uint8_t ballPixelY(const PongState &state) { return toPixel(state.ball_y); }
+
+// Start a new match from the given random seed
+void pongReset(PongState &state, uint32_t seed);
+
+// Put the ball back in the middle with a random direction, reset paddles and
+// pick a new CPU difficulty level
+void pongServe(PongState &state);
+
+// Advance the simulation by exactly one tick. Goals update the score and serve again.
+PongEvent pongStep(PongState &state, const PongInputs &inputs);
+
+// Move the ball along its velocity for 'duration' (tick fraction, 8.8, at most 16 ticks),
+// bouncing off every wall and paddle it meets on the way in order of time of impact, so no
+// displacement is too large to tunnel through anything. Paddle hits deflect and speed the
+// ball up. Fills 'contacts' (MAX_CONTACTS entries, may be null) and returns the number of
+// bounces. Goals are left to the caller (the ball ends up past BALL_MIN_X/BALL_MAX_X, pinned
+// to the int16 range if the sweep would carry it further).
+uint8_t pongSweepBall(PongState &state, uint16_t duration, PongContact *contacts);
+
+// Next number from the state's random generator
+uint32_t pongRandom(PongState &state);
+
+#endif
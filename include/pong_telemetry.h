@@ -0,0 +1,144 @@
+#ifndef PONG_TELEMETRY_H
+#define PONG_TELEMETRY_H
+
+#include <Arduino.h>
+#include <pong_sched.h>
+
+// Runtime counters, dumped over Serial on demand (main.cpp reads the commands):
+//   't'  print the counters    'r'  reset them
+// Build with -DPONG_TELEMETRY=0 to compile every hook below down to nothing.
+#ifndef PONG_TELEMETRY
+#define PONG_TELEMETRY 1
+#endif
+
+// Flush duration histogram: bucket 0 counts flushes under 256 us, every next bucket
+// doubles the limit, the last one counts everything slower
+#define TELEMETRY_FLUSH_BUCKETS 8
+#define TELEMETRY_FLUSH_SHIFT   8
+
+#if PONG_TELEMETRY
+
+// Deadline record of one scheduler task
+struct TelemetryTask
+{
+    uint32_t runs;                  // Passes that found the task due
+    uint32_t late;                  // Total time from deadline to run (scheduler ticks)
+    SchedTime max_late;
+    uint16_t missed;                // Deadlines dropped because the loop fell too far behind
+};
+
+struct Telemetry
+{
+    TelemetryTask tasks[SCHED_TASKS];
+
+    uint32_t ticks;                 // Simulation ticks run
+    uint32_t frames;                // Rally frames rendered
+    uint8_t max_frame_ticks;        // Most ticks run between two rendered frames
+    uint8_t frame_ticks;            // Ticks run since the last rendered frame
+
+    uint16_t flush_histogram[TELEMETRY_FLUSH_BUCKETS];
+    uint32_t flush_us;              // Total time spent flushing
+    uint16_t max_flush_us;
+    uint32_t bus_bytes;             // I2C bytes sent to the panel, address bytes included
+
+    uint16_t inputs;                // Button presses that reached the screen
+    uint32_t input_latency_ms;      // Total press to frame handed to the panel time
+    uint16_t max_input_latency_ms;
+    bool input_pending;
+    unsigned long input_time;       // Oldest press not on screen yet
+
+    // Duty cycle: time asleep between ticks, out of the time since the last reset
+    unsigned long since_ms;         // millis() at the last reset
+    uint32_t sleep_ms;              // Idle sleep, whole milliseconds...
+    uint16_t sleep_us;              // ...and the microseconds not counted there yet
+    uint32_t power_down_ms;         // Time powered down (millis() stops with the clocks on AVR)
+    uint16_t power_downs;
+};
+
+extern Telemetry telemetry;
+
+void telemetryBegin();
+void telemetryReset();
+
+// Handle a Serial command; returns false if it is not a telemetry command
+bool telemetryCommand(char command);
+
+inline void telemetryTicks(uint8_t ran)
+{
+    telemetry.ticks += ran;
+    telemetry.frame_ticks += ran;
+}
+
+// A scheduler task ran 'late' after its deadline, with 'missed' deadlines dropped
+inline void telemetryTask(uint8_t task, SchedTime late, uint16_t missed)
+{
+    TelemetryTask &record = telemetry.tasks[task];
+    record.runs++;
+    record.late += late;
+    if (late > record.max_late) record.max_late = late;
+    record.missed += missed;
+}
+
+inline void telemetryBusBytes(uint16_t bytes)
+{
+    telemetry.bus_bytes += bytes;
+}
+
+// A press to time until the frame showing its effect is handed to the panel: flushed on SPI,
+// queued by flushAsync() on I2C. The I2C transfer after that (a few ms at 400 kHz) is not
+// included, so this is press to frame sent, not press to pixels.
+inline void telemetryInput(unsigned long time)
+{
+    if (telemetry.input_pending) return;
+    telemetry.input_pending = true;
+    telemetry.input_time = time;
+}
+
+// Slept 'us' between two loop passes (called a few thousand times a second: stays cheap)
+inline void telemetrySleep(uint16_t us)
+{
+    telemetry.sleep_us += us;
+    while (telemetry.sleep_us >= 1000)
+    {
+        telemetry.sleep_us -= 1000;
+        telemetry.sleep_ms++;
+    }
+}
+
+// Woke up from power down after 'ms'
+inline void telemetryPowerDown(unsigned long ms)
+{
+    telemetry.power_down_ms += ms;
+    telemetry.power_downs++;
+}
+
+// The rally ended: a press no rally frame showed yet is not counted (the next frame comes
+// after the banner, so its latency would be the banner's)
+inline void telemetryCancelInput()
+{
+    telemetry.input_pending = false;
+}
+
+void telemetryFlush(uint16_t duration_us);
+
+// A rally frame was flushed, or queued for the background transfer, at 'time'
+void telemetryFrame(unsigned long time);
+
+#else
+
+inline void telemetryBegin() {}
+inline void telemetryReset() {}
+inline bool telemetryCommand(char) { return false; }
+inline void telemetryTicks(uint8_t) {}
+inline void telemetryTask(uint8_t, SchedTime, uint16_t) {}
+inline void telemetryBusBytes(uint16_t) {}
+inline void telemetryInput(unsigned long) {}
+inline void telemetryCancelInput() {}
+inline void telemetrySleep(uint16_t) {}
+inline void telemetryPowerDown(unsigned long) {}
+inline void telemetryFlush(uint16_t) {}
+inline void telemetryFrame(unsigned long) {}
+
+#endif
+
+#endif
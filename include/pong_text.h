@@ -0,0 +1,50 @@
+#ifndef PONG_TEXT_H
+#define PONG_TEXT_H
+
+#include <Arduino.h>
+
+// Built-in Adafruit GFX font: 5x7 glyphs in a 6x8 cell per text size step
+#define FONT_CHAR_WIDTH     6
+#define FONT_CHAR_HEIGHT    8
+
+// Longest line of text any screen builds at runtime, terminator included
+#define TEXT_BUFFER_SIZE   24
+
+// Pixel size of 'length' characters of the built-in font, same as getTextBounds() reports
+constexpr uint16_t textWidth(uint8_t length, uint8_t size)
+{
+    return (uint16_t)length * FONT_CHAR_WIDTH * size;
+}
+
+constexpr uint16_t textHeight(uint8_t size)
+{
+    return (uint16_t)FONT_CHAR_HEIGHT * size;
+}
+
+// Left edge that centers 'length' characters across 'area_width' pixels
+constexpr int16_t textCenterX(uint16_t area_width, uint8_t length, uint8_t size)
+{
+    return ((int16_t)area_width - (int16_t)textWidth(length, size)) / 2;
+}
+
+// Number of characters in a string literal
+#define TEXT_LENGTH(literal) (sizeof(literal) - 1)
+
+// Fixed-capacity text line assembled on the stack, so no screen ever touches the heap.
+// Appends that do not fit are truncated.
+struct TextBuffer
+{
+    char text[TEXT_BUFFER_SIZE];
+    uint8_t length;
+
+    TextBuffer() : length(0) { text[0] = '\0'; }
+
+    void append(char c);
+    void append_P(const char *str);
+    void appendUnsigned(uint16_t value);
+};
+
+// Write 'value' as decimal digits to 'out' (at least 6 bytes), returns the digit count
+uint8_t formatUnsigned(char *out, uint16_t value);
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef PONG_TWI_H
+#define PONG_TWI_H
+
+#include <Arduino.h>
+
+// Non-blocking I2C master for panel writes. Transactions (address, one control byte, then
+// 'length' bytes read straight from RAM or PROGMEM, with no intermediate buffer and no
+// 32-byte limit) are queued and sent in the background while the game keeps running; the
+// queued data must stay untouched until twiBusy() turns false.
+//
+// The transmitter is a state machine that hands the hardware its next byte each time the
+// last one is done (TWINT). With PONG_TWI_TRANSPORT 1 nothing uses Wire: twiInit() sets the
+// hardware up instead of Wire.begin(), which keeps Wire's five 32-byte buffers out of the
+// Uno's 2 KB, and the TWI interrupt runs the state machine (TWI_INTERRUPT), so the CPU can
+// sleep through a transfer. twiService() only starts one.
+//
+// With PONG_TWI_TRANSPORT 0, Wire's twi.c owns the interrupt vector, so twiService() polls
+// TWINT instead, on every main loop pass. Wire must not be used before twiFinish().
+
+// Bus clock for the panel transfers (Hz)
+#ifndef PONG_TWI_CLOCK
+#define PONG_TWI_CLOCK  400000UL
+#endif
+
+// 1: PongDisplay sends every panel write through this transport, one long transaction per
+// page span. 0: synchronous writes go through Wire in 32-byte chunks like Adafruit_SSD1306,
+// only flushAsync() uses this transport.
+#ifndef PONG_TWI_TRANSPORT
+#define PONG_TWI_TRANSPORT  1
+#endif
+
+// 1 when the TWI interrupt (emulated by the native HAL on the host) runs the transmitter
+#define TWI_INTERRUPT       PONG_TWI_TRANSPORT
+
+// Most transactions queued at once (a power of two)
+#define TWI_QUEUE_SIZE  16
+
+// Transaction flags
+#define TWI_PROGMEM     0x01    // 'data' points to PROGMEM
+#define TWI_REPEAT      0x02    // Send the byte at 'data' 'length' times
+
+struct TwiTransaction
+{
+    const uint8_t *data;
+    uint8_t length;
+    uint8_t control;
+    uint8_t flags;
+};
+
+// Pull-ups and TWI on, like Wire.begin() minus its interrupt and buffers
+void twiInit();
+
+// Set the 7-bit device address all transactions go to (twiInit() or Wire.begin() must
+// have run)
+void twiBegin(uint8_t address);
+
+// Queue one transaction; returns false (nothing queued) when the queue is full
+bool twiQueue(uint8_t control, const uint8_t *data, uint8_t length, uint8_t flags = 0);
+
+// Free queue entries
+uint8_t twiQueueSpace();
+
+// True while anything is queued or on the bus
+bool twiBusy();
+
+// True while a transfer needs twiService() calls to move on: anything queued when polling,
+// only a queue the transmitter has not started on when the interrupt runs it
+bool twiWaiting();
+
+// Start a queued transfer, or when polling, advance it as far as the hardware allows; never
+// waits
+void twiService();
+
+// Wait until everything queued has been sent
+void twiFinish();
+
+// Transfers abandoned because the device did not acknowledge (the queue is dropped)
+uint16_t twiErrors();
+
+#endif
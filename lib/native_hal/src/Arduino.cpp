@@ -0,0 +1,305 @@
+#include <Arduino.h>
+#include <native_hal.h>
+
+#include <stdio.h>
+#include <string>
+
+// Virtual clock state
+static uint64_t now_us = 0;
+
+// Pin state (pulled-up inputs read HIGH until a script or test drives them LOW)
+static uint8_t pin_levels[NATIVE_PIN_COUNT];
+static bool pin_outputs[NATIVE_PIN_COUNT];
+static bool pins_initialised = false;
+static NativeInputScript input_script = nullptr;
+static bool in_input_script = false;
+static NativePinChangeHandler pin_change_handler = nullptr;
+
+static NativeBusStats bus_stats;
+static NativeI2CSink i2c_sink = nullptr;
+static NativeSPISink spi_sink = nullptr;
+
+static void initPins()
+{
+    if (pins_initialised) return;
+    memset(pin_levels, HIGH, sizeof(pin_levels));
+    pins_initialised = true;
+}
+
+// Every clock advance gives the input script a chance to move the pins, so pin changes
+// (and the emulated pin change interrupt) also land during delays and bus transfers. The
+// emulated TWI interrupt runs at the moment each operation inside the advance finishes.
+static void advanceClock(uint64_t us)
+{
+    uint64_t until = now_us + us;
+    uint64_t at;
+    while (nativeTwiInterruptAt(at) && at <= until)
+    {
+        if (at > now_us) now_us = at;
+        nativeTwiInterrupt();
+    }
+    // The handler's own calls may have moved the clock past 'until' already
+    if (now_us < until) now_us = until;
+    if (!input_script || in_input_script) return;
+    in_input_script = true;
+    input_script((unsigned long)(now_us / 1000));
+    in_input_script = false;
+}
+
+uint64_t nativeMicros()
+{
+    return now_us;
+}
+
+void nativeAdvanceMicros(uint64_t us)
+{
+    advanceClock(us);
+}
+
+void nativeResetClock()
+{
+    now_us = 0;
+}
+
+void nativeSetPin(uint8_t pin, uint8_t level)
+{
+    initPins();
+    if (pin >= NATIVE_PIN_COUNT) return;
+
+    level = level ? HIGH : LOW;
+    if (pin_levels[pin] == level) return;
+    pin_levels[pin] = level;
+    if (pin_change_handler) pin_change_handler(pin);
+}
+
+uint8_t nativeGetPin(uint8_t pin)
+{
+    initPins();
+    return pin < NATIVE_PIN_COUNT ? pin_levels[pin] : LOW;
+}
+
+void nativeSetInputScript(NativeInputScript script)
+{
+    input_script = script;
+}
+
+void nativeAttachPinChange(NativePinChangeHandler handler)
+{
+    pin_change_handler = handler;
+}
+
+const NativeBusStats &nativeBusStats()
+{
+    return bus_stats;
+}
+
+void nativeResetBusStats()
+{
+    memset(&bus_stats, 0, sizeof(bus_stats));
+}
+
+void nativeAccountBus(uint32_t bytes, uint64_t busy_us)
+{
+    nativeRecordBus(bytes, busy_us);
+    advanceClock(busy_us);
+}
+
+void nativeRecordBus(uint32_t bytes, uint64_t busy_us)
+{
+    bus_stats.transactions++;
+    bus_stats.bytes += bytes;
+    bus_stats.busy_us += busy_us;
+}
+
+void nativeSetI2CSink(NativeI2CSink sink)
+{
+    i2c_sink = sink;
+}
+
+void nativeNotifyI2C(uint8_t address, const uint8_t *data, uint8_t length)
+{
+    if (i2c_sink) i2c_sink(address, data, length);
+}
+
+void nativeSetSPISink(NativeSPISink sink)
+{
+    spi_sink = sink;
+}
+
+void nativeNotifySPI(uint8_t data)
+{
+    if (spi_sink) spi_sink(data);
+}
+
+// Arduino core API
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    initPins();
+    if (pin >= NATIVE_PIN_COUNT) return;
+    pin_outputs[pin] = mode == OUTPUT;
+    if (mode == INPUT_PULLUP) pin_levels[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    // Outputs (chip select, data/command) take the level; writing HIGH to an input enables
+    // its pull-up on AVR, which the pins already model
+    initPins();
+    if (pin < NATIVE_PIN_COUNT && pin_outputs[pin]) pin_levels[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin)
+{
+    advanceClock(NATIVE_CALL_COST_US);
+    return nativeGetPin(pin);
+}
+
+unsigned long millis()
+{
+    advanceClock(NATIVE_CALL_COST_US);
+    return (unsigned long)(now_us / 1000);
+}
+
+unsigned long micros()
+{
+    advanceClock(NATIVE_CALL_COST_US);
+    return (unsigned long)now_us;
+}
+
+void delay(unsigned long ms)
+{
+    // One millisecond at a time, so scripted input keeps changing during long delays
+    while (ms--) advanceClock(1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    advanceClock(us);
+}
+
+long random(long howbig)
+{
+    return howbig ? rand() % howbig : 0;
+}
+
+long random(long howsmall, long howbig)
+{
+    return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+    if (seed) srand((unsigned int)seed);
+}
+
+// Print
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+}
+
+size_t Print::print(const __FlashStringHelper *str)
+{
+    return print(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(const String &str)
+{
+    return print(str.c_str());
+}
+
+size_t Print::print(const char *str)
+{
+    return write(str);
+}
+
+size_t Print::print(char c)
+{
+    return write((uint8_t)c);
+}
+
+size_t Print::print(int value, int base)
+{
+    return print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base)
+{
+    if (base == 10 && value < 0)
+    {
+        return print('-') + printNumber((unsigned long)-value, base);
+    }
+    return printNumber((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    return printNumber(value, base);
+}
+
+size_t Print::println()
+{
+    return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper *str) { return print(str) + println(); }
+size_t Print::println(const String &str) { return print(str) + println(); }
+size_t Print::println(const char *str) { return print(str) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(int value, int base) { return print(value, base) + println(); }
+size_t Print::println(unsigned int value, int base) { return print(value, base) + println(); }
+size_t Print::println(long value, int base) { return print(value, base) + println(); }
+size_t Print::println(unsigned long value, int base) { return print(value, base) + println(); }
+
+size_t Print::printNumber(unsigned long value, int base)
+{
+    char buf[8 * sizeof(long) + 1];
+    char *str = &buf[sizeof(buf) - 1];
+    *str = '\0';
+    if (base < 2) base = 10;
+    do
+    {
+        char c = (char)(value % base);
+        value /= base;
+        *--str = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (value);
+    return write(str);
+}
+
+// Serial
+
+HardwareSerial Serial;
+static std::string serial_input;
+
+int HardwareSerial::available()
+{
+    return (int)serial_input.size();
+}
+
+int HardwareSerial::read()
+{
+    if (serial_input.empty()) return -1;
+    int c = (uint8_t)serial_input[0];
+    serial_input.erase(0, 1);
+    return c;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    if (c != '\r') putchar(c);
+    return 1;
+}
+
+void nativeSerialInject(const char *text)
+{
+    serial_input += text;
+}
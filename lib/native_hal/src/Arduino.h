@@ -0,0 +1,64 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Minimal Arduino core API for host builds (see native_hal.h for the virtual clock)
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define ARDUINO 10819
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH            1
+#define LOW             0
+#define INPUT           0x0
+#define OUTPUT          0x1
+#define INPUT_PULLUP    0x2
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+// Flash access collapses to plain memory on the host
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr)   (*(void * const *)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strncpy_P strncpy
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+#define interrupts()
+#define noInterrupts()
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+#include "WString.h"
+#include "Print.h"
+#include "HardwareSerial.h"
+
+// Sketch entry points
+void setup();
+void loop();
+
+#endif
@@ -0,0 +1,73 @@
+#include <EEPROM.h>
+#include <native_hal.h>
+
+#include <stdio.h>
+
+// Virtual time one EEPROM byte write takes (erase and write, as on the ATmega328P)
+#define NATIVE_EEPROM_WRITE_US 3300
+
+EEPROMClass EEPROM;
+
+static uint8_t eeprom[NATIVE_EEPROM_SIZE];
+static bool eeprom_initialised = false;
+static uint64_t eeprom_busy_until = 0;     // Virtual time the last write completes
+
+// Reads and writes wait for a write in progress, like eeprom_read_byte()/eeprom_write_byte()
+static void waitEEPROM()
+{
+    uint64_t now = nativeMicros();
+    if (now < eeprom_busy_until) nativeAdvanceMicros(eeprom_busy_until - now);
+}
+
+static void initEEPROM()
+{
+    if (eeprom_initialised) return;
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    eeprom_initialised = true;
+}
+
+uint8_t EEPROMClass::read(int address)
+{
+    initEEPROM();
+    waitEEPROM();
+    return address >= 0 && address < NATIVE_EEPROM_SIZE ? eeprom[address] : 0xFF;
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+    initEEPROM();
+    if (address < 0 || address >= NATIVE_EEPROM_SIZE) return;
+    waitEEPROM();
+    eeprom[address] = value;
+    eeprom_busy_until = nativeMicros() + NATIVE_EEPROM_WRITE_US;
+}
+
+bool nativeEEPROMReady()
+{
+    return nativeMicros() >= eeprom_busy_until;
+}
+
+void EEPROMClass::update(int address, uint8_t value)
+{
+    if (read(address) != value) write(address, value);
+}
+
+bool nativeEEPROMLoad(const char *path)
+{
+    initEEPROM();
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+    size_t length = fread(eeprom, 1, sizeof(eeprom), file);
+    fclose(file);
+    return length > 0;
+}
+
+bool nativeEEPROMSave(const char *path)
+{
+    initEEPROM();
+    FILE *file = fopen(path, "wb");
+    if (!file) return false;
+    size_t length = fwrite(eeprom, 1, sizeof(eeprom), file);
+    fclose(file);
+    return length == sizeof(eeprom);
+}
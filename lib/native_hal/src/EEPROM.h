@@ -0,0 +1,23 @@
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+#include <Arduino.h>
+
+// Same size as the Uno's EEPROM
+#define NATIVE_EEPROM_SIZE 1024
+
+// EEPROM stand-in: 1 KB in memory, erased (0xFF) at start, optionally loaded from and saved
+// to a file with nativeEEPROMLoad()/nativeEEPROMSave(). Every byte actually written takes
+// the AVR's 3.3 ms of virtual time in the background, and the next access waits for it.
+class EEPROMClass
+{
+public:
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    void update(int address, uint8_t value);
+    uint16_t length() { return NATIVE_EEPROM_SIZE; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
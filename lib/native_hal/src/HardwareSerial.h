@@ -0,0 +1,25 @@
+#ifndef NATIVE_HARDWARE_SERIAL_H
+#define NATIVE_HARDWARE_SERIAL_H
+
+#include "Print.h"
+
+// Serial port stand-in: output goes to stdout, input comes from nativeSerialInject()
+class HardwareSerial : public Print
+{
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    int available();
+    int read();
+    size_t write(uint8_t c) override;
+    using Print::write;
+    // Output is written as it comes, nothing to wait for
+    void flush() {}
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// Queue bytes to be returned by Serial.read()
+void nativeSerialInject(const char *text);
+
+#endif
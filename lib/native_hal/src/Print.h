@@ -0,0 +1,44 @@
+#ifndef NATIVE_PRINT_H
+#define NATIVE_PRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class __FlashStringHelper;
+class String;
+
+// Arduino Print base class: subclasses implement write(uint8_t)
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+
+    size_t print(const __FlashStringHelper *str);
+    size_t print(const String &str);
+    size_t print(const char *str);
+    size_t print(char c);
+    size_t print(int value, int base = 10);
+    size_t print(unsigned int value, int base = 10);
+    size_t print(long value, int base = 10);
+    size_t print(unsigned long value, int base = 10);
+
+    size_t println();
+    size_t println(const __FlashStringHelper *str);
+    size_t println(const String &str);
+    size_t println(const char *str);
+    size_t println(char c);
+    size_t println(int value, int base = 10);
+    size_t println(unsigned int value, int base = 10);
+    size_t println(long value, int base = 10);
+    size_t println(unsigned long value, int base = 10);
+
+private:
+    size_t printNumber(unsigned long value, int base);
+};
+
+#endif
@@ -0,0 +1,25 @@
+#include <SPI.h>
+#include <native_hal.h>
+
+SPIClass SPI;
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+    clock = settings.clock;
+    tx_bytes = 0;
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+    nativeNotifySPI(data);
+    tx_bytes++;
+    return 0;
+}
+
+void SPIClass::endTransaction()
+{
+    // 8 clocks per byte, nothing else on the wire
+    uint64_t bits = (uint64_t)tx_bytes * 8;
+    nativeAccountBus(tx_bytes, (bits * 1000000 + clock - 1) / clock);
+    tx_bytes = 0;
+}
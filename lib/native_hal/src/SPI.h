@@ -0,0 +1,40 @@
+#ifndef NATIVE_SPI_H
+#define NATIVE_SPI_H
+
+#include <Arduino.h>
+
+#define SPI_HAS_TRANSACTION 1
+
+#define MSBFIRST  1
+#define LSBFIRST  0
+#define SPI_MODE0 0x00
+
+class SPISettings
+{
+public:
+    SPISettings(uint32_t clock = 4000000, uint8_t bit_order = MSBFIRST, uint8_t data_mode = SPI_MODE0)
+        : clock(clock), bit_order(bit_order), data_mode(data_mode) {}
+
+    uint32_t clock;
+    uint8_t bit_order;
+    uint8_t data_mode;
+};
+
+// SPI master stand-in: each transaction is timed at its clock rate against the virtual clock
+class SPIClass
+{
+public:
+    void begin() {}
+    void end() {}
+    void beginTransaction(SPISettings settings);
+    uint8_t transfer(uint8_t data);
+    void endTransaction();
+
+private:
+    uint32_t clock = 4000000;
+    uint32_t tx_bytes = 0;
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,103 @@
+#include <Arduino.h>
+#include <native_hal.h>
+
+// Background TWI peripheral state
+static uint32_t twi_clock = 100000;
+static uint64_t twi_ready_at = 0;       // Virtual time the current operation completes
+static bool twi_active = false;         // Between START and STOP
+static bool twi_addressed = false;      // Address byte sent
+static uint8_t twi_address;
+static uint8_t twi_buffer[255];
+static uint16_t twi_length;
+static uint32_t twi_bits;               // Bus clocks used by the current transaction
+
+// Emulated TWI interrupt
+static NativeTwiHandler twi_handler = nullptr;
+static bool twi_interrupt_pending = false;  // A START or byte raises it when done
+static bool in_twi_interrupt = false;
+
+// Queue an operation of 'bits' bus clocks after the previous one
+static void twiOperation(uint32_t bits)
+{
+    uint64_t now = nativeMicros();
+    uint64_t start = twi_ready_at > now ? twi_ready_at : now;
+    twi_ready_at = start + ((uint64_t)bits * 1000000 + twi_clock - 1) / twi_clock;
+    twi_bits += bits;
+}
+
+// Report the transaction in progress, like TwoWire::endTransmission() does
+static void twiComplete()
+{
+    uint32_t bytes = (twi_addressed ? 1 : 0) + twi_length;
+    nativeRecordBus(bytes, ((uint64_t)twi_bits * 1000000 + twi_clock - 1) / twi_clock);
+    if (twi_addressed) nativeNotifyI2C(twi_address, twi_buffer, (uint8_t)twi_length);
+    twi_active = false;
+}
+
+void nativeTwiSetClock(uint32_t hz)
+{
+    if (hz) twi_clock = hz;
+}
+
+void nativeTwiStart()
+{
+    // A repeated START ends the previous transaction
+    if (twi_active) twiComplete();
+    twi_active = true;
+    twi_addressed = false;
+    twi_length = 0;
+    twi_bits = 0;
+    twiOperation(1);
+    twi_interrupt_pending = true;
+}
+
+void nativeTwiWrite(uint8_t data)
+{
+    if (!twi_active) return;
+    if (!twi_addressed)
+    {
+        twi_address = data >> 1;
+        twi_addressed = true;
+    }
+    else if (twi_length < sizeof(twi_buffer))
+    {
+        twi_buffer[twi_length++] = data;
+    }
+    twiOperation(9);
+    twi_interrupt_pending = true;
+}
+
+void nativeTwiStop()
+{
+    if (!twi_active) return;
+    twiOperation(1);
+    twiComplete();
+    twi_interrupt_pending = false;
+}
+
+bool nativeTwiReady()
+{
+    // Polling costs time like any other call, so a wait loop makes progress
+    return micros() >= twi_ready_at;
+}
+
+void nativeAttachTwiInterrupt(NativeTwiHandler handler)
+{
+    twi_handler = handler;
+}
+
+bool nativeTwiInterruptAt(uint64_t &at)
+{
+    // Interrupts are disabled while the handler runs
+    if (!twi_handler || !twi_interrupt_pending || in_twi_interrupt) return false;
+    at = twi_ready_at;
+    return true;
+}
+
+void nativeTwiInterrupt()
+{
+    twi_interrupt_pending = false;
+    in_twi_interrupt = true;
+    twi_handler();
+    in_twi_interrupt = false;
+}
@@ -0,0 +1,37 @@
+#ifndef NATIVE_WSTRING_H
+#define NATIVE_WSTRING_H
+
+#include <string>
+
+// Just enough of Arduino's String for the sketch's concatenation and comparisons
+class String
+{
+public:
+    String(const char *cstr = "") : s(cstr) {}
+    String(const std::string &str) : s(str) {}
+    explicit String(char c) : s(1, c) {}
+    explicit String(int value) : s(std::to_string(value)) {}
+    explicit String(unsigned int value) : s(std::to_string(value)) {}
+    explicit String(long value) : s(std::to_string(value)) {}
+    explicit String(unsigned long value) : s(std::to_string(value)) {}
+
+    const char *c_str() const { return s.c_str(); }
+    unsigned int length() const { return (unsigned int)s.length(); }
+
+    String &operator+=(const String &rhs) { s += rhs.s; return *this; }
+    String &operator+=(const char *rhs) { s += rhs; return *this; }
+
+    friend String operator+(const String &lhs, const String &rhs) { return String(lhs.s + rhs.s); }
+    friend String operator+(const String &lhs, const char *rhs) { return String(lhs.s + rhs); }
+    friend String operator+(const char *lhs, const String &rhs) { return String(lhs + rhs.s); }
+
+    bool operator==(const String &rhs) const { return s == rhs.s; }
+    bool operator==(const char *rhs) const { return s == rhs; }
+    bool operator!=(const String &rhs) const { return s != rhs.s; }
+    bool operator!=(const char *rhs) const { return s != rhs; }
+
+private:
+    std::string s;
+};
+
+#endif
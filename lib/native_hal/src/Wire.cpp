@@ -0,0 +1,36 @@
+#include <Wire.h>
+#include <native_hal.h>
+
+TwoWire Wire;
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    tx_address = address;
+    tx_length = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool send_stop)
+{
+    (void)send_stop;
+    // Address byte + payload, 9 clocks per byte (8 data + ACK) plus START and STOP
+    uint32_t bytes = 1 + tx_length;
+    uint64_t bits = (uint64_t)bytes * 9 + 2;
+    nativeAccountBus(bytes, (bits * 1000000 + bus_clock - 1) / bus_clock);
+    nativeNotifyI2C(tx_address, tx_buffer, tx_length);
+    tx_length = 0;
+    return 0;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+    if (tx_length >= BUFFER_LENGTH) return 0;
+    tx_buffer[tx_length++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity)
+{
+    size_t n = 0;
+    while (n < quantity && write(data[n])) n++;
+    return n;
+}
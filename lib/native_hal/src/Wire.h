@@ -0,0 +1,30 @@
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include <Arduino.h>
+
+// Same transmit buffer size as the AVR Wire library
+#define BUFFER_LENGTH 32
+
+// I2C master stand-in: transactions are counted, timed against the virtual clock at the
+// configured bus speed and handed to the optional nativeSetI2CSink() observer
+class TwoWire
+{
+public:
+    void begin() {}
+    void setClock(uint32_t clock) { bus_clock = clock; }
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool send_stop = true);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t quantity);
+
+private:
+    uint32_t bus_clock = 100000;
+    uint8_t tx_address = 0;
+    uint8_t tx_buffer[BUFFER_LENGTH];
+    uint8_t tx_length = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
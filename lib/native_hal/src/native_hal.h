@@ -0,0 +1,85 @@
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+#include <stdint.h>
+
+// Host-side control surface for the stub Arduino environment.
+// Time never advances on its own: it moves forward when the game calls delay(), when
+// bus transfers take place, and by a small fixed cost per millis()/micros()/digitalRead()
+// call, so busy-wait loops in game code still make progress. The input script runs on
+// every advance.
+
+// Virtual cost of one millis()/micros()/digitalRead() call (roughly what an Uno pays)
+#define NATIVE_CALL_COST_US 2
+
+// Number of emulated digital pins
+#define NATIVE_PIN_COUNT 20
+
+// Virtual clock
+uint64_t nativeMicros();
+void nativeAdvanceMicros(uint64_t us);
+void nativeResetClock();
+
+// Digital pins (inputs default to HIGH, i.e. released buttons with pull-ups)
+void nativeSetPin(uint8_t pin, uint8_t level);
+uint8_t nativeGetPin(uint8_t pin);
+
+// Optional input script, called whenever the virtual clock advances with the current time
+typedef void (*NativeInputScript)(unsigned long now_ms);
+void nativeSetInputScript(NativeInputScript script);
+
+// Optional pin change "interrupt", called from nativeSetPin() whenever a level changes
+typedef void (*NativePinChangeHandler)(uint8_t pin);
+void nativeAttachPinChange(NativePinChangeHandler handler);
+
+// Bus accounting shared by the Wire and SPI stubs
+struct NativeBusStats
+{
+    uint32_t transactions;  // I2C START..STOP sequences or SPI chip-select windows
+    uint32_t bytes;         // Bytes on the wire, including I2C address bytes
+    uint64_t busy_us;       // Virtual time spent transferring
+};
+const NativeBusStats &nativeBusStats();
+void nativeResetBusStats();
+// Record a blocking transfer and advance the clock by its duration
+void nativeAccountBus(uint32_t bytes, uint64_t busy_us);
+// Record a transfer that ran in the background (the clock is not advanced)
+void nativeRecordBus(uint32_t bytes, uint64_t busy_us);
+
+// Register-level TWI peripheral for drivers that bypass Wire. Each operation runs in the
+// background for its bus time at the configured clock (every byte is ACKed), and
+// nativeTwiReady() turns true once it is done, like the TWINT flag. Completed transactions
+// are recorded in the bus stats and passed to the I2C sink like Wire's.
+void nativeTwiSetClock(uint32_t hz);
+void nativeTwiStart();
+void nativeTwiWrite(uint8_t data);      // The first byte after a START is the address byte
+void nativeTwiStop();
+bool nativeTwiReady();
+
+// Optional TWI interrupt: while attached, 'handler' runs when the virtual clock passes the
+// end of a START or byte, like TWINT with TWIE set (a STOP raises none). The clock asks
+// nativeTwiInterruptAt() when it is due, false if it is not, and runs it with
+// nativeTwiInterrupt().
+typedef void (*NativeTwiHandler)();
+void nativeAttachTwiInterrupt(NativeTwiHandler handler);
+bool nativeTwiInterruptAt(uint64_t &at);
+void nativeTwiInterrupt();
+
+// EEPROM contents from/to a file (a shorter file leaves the rest erased)
+bool nativeEEPROMLoad(const char *path);
+bool nativeEEPROMSave(const char *path);
+// Whether the last EEPROM byte write is done, like eeprom_is_ready()
+bool nativeEEPROMReady();
+
+// Optional observer for every completed I2C transaction (address + payload)
+typedef void (*NativeI2CSink)(uint8_t address, const uint8_t *data, uint8_t length);
+void nativeSetI2CSink(NativeI2CSink sink);
+void nativeNotifyI2C(uint8_t address, const uint8_t *data, uint8_t length);
+
+// Optional observer for every byte sent over SPI; chip select and data/command are output
+// pins, readable with nativeGetPin() from the observer
+typedef void (*NativeSPISink)(uint8_t data);
+void nativeSetSPISink(NativeSPISink sink);
+void nativeNotifySPI(uint8_t data);
+
+#endif
@@ -0,0 +1,68 @@
+// Host entry point: runs the sketch's setup()/loop() against the virtual clock for a fixed
+// amount of virtual time with a scripted player, then prints bus and loop statistics.
+//   --ms N        virtual time to run (default 60000)
+//   --seed N      scripted player seed (default 1)
+//   --eeprom F    load EEPROM from file F before the run and save it back afterwards
+//   --serial S    bytes waiting on Serial at start (commands for the sketch)
+// Tools that bring their own main() build with -DNATIVE_HAL_NO_MAIN.
+#ifndef NATIVE_HAL_NO_MAIN
+
+#include <Arduino.h>
+#include <native_hal.h>
+
+#include <stdio.h>
+
+// Scripted player: every 40 ms holds a random one of {nothing, pin 6, pin 7}
+static uint32_t script_state = 1;
+static unsigned long script_next_ms = 0;
+
+static void randomPlayer(unsigned long now_ms)
+{
+    if (now_ms < script_next_ms) return;
+    script_next_ms = now_ms + 40;
+
+    script_state = script_state * 1103515245u + 12345u;
+    uint8_t choice = (script_state >> 16) % 3;
+    nativeSetPin(6, choice == 1 ? LOW : HIGH);
+    nativeSetPin(7, choice == 2 ? LOW : HIGH);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long run_ms = 60000;
+    unsigned long seed = 1;
+    const char *eeprom_path = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--ms")) run_ms = strtoul(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--seed")) seed = strtoul(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--eeprom")) eeprom_path = argv[i + 1];
+        else if (!strcmp(argv[i], "--serial")) nativeSerialInject(argv[i + 1]);
+    }
+    if (eeprom_path) nativeEEPROMLoad(eeprom_path);
+
+    srand((unsigned int)seed);
+    script_state = (uint32_t)seed;
+    nativeSetInputScript(randomPlayer);
+
+    setup();
+    uint64_t loops = 0;
+    while (millis() < run_ms)
+    {
+        loop();
+        loops++;
+    }
+    if (eeprom_path) nativeEEPROMSave(eeprom_path);
+
+    const NativeBusStats &bus = nativeBusStats();
+    uint64_t elapsed_us = nativeMicros();
+    printf("virtual time     %llu ms\n", (unsigned long long)(elapsed_us / 1000));
+    printf("loop() passes    %llu\n", (unsigned long long)loops);
+    printf("bus transactions %u\n", bus.transactions);
+    printf("bus bytes        %u\n", bus.bytes);
+    printf("bus busy         %llu ms (%.1f%%)\n", (unsigned long long)(bus.busy_us / 1000),
+           elapsed_us ? 100.0 * bus.busy_us / elapsed_us : 0.0);
+    return 0;
+}
+
+#endif
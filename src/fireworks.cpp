@@ -0,0 +1,58 @@
+#include <fireworks.h>
+#include <fireworks_delta.h>
+
+void fireworksBegin(FireworksDecoder &decoder)
+{
+    decoder.position = 0;
+    decoder.offset = FIREWORKS_FRAME_BYTES;
+    decoder.frame = 0;
+}
+
+bool fireworksNextFrame(FireworksDecoder &decoder)
+{
+    // Finish any runs the caller did not consume
+    FireworksRun run;
+    while (fireworksNextRun(decoder, run));
+
+    if (decoder.frame >= FIREWORKS_FRAME_COUNT) return false;
+    decoder.offset = 0;
+    decoder.frame++;
+    return true;
+}
+
+bool fireworksNextRun(FireworksDecoder &decoder, FireworksRun &run)
+{
+    while (decoder.offset < FIREWORKS_FRAME_BYTES)
+    {
+        uint8_t token = pgm_read_byte(fireworks_stream + decoder.position++);
+        if (token < 0x80)
+        {
+            // Unchanged bytes
+            decoder.offset += token + 1;
+            continue;
+        }
+
+        // Literal bytes, or a repeated byte
+        run.offset = decoder.offset;
+        run.length = (token & 0x3F) + 1;
+        run.repeat = token >= 0xC0;
+        run.data = fireworks_stream + decoder.position;
+        decoder.position += run.repeat ? 1 : run.length;
+        decoder.offset += run.length;
+        return true;
+    }
+    return false;
+}
+
+bool fireworksDecodeFrame(FireworksDecoder &decoder, uint8_t *buffer)
+{
+    if (!fireworksNextFrame(decoder)) return false;
+
+    FireworksRun run;
+    while (fireworksNextRun(decoder, run))
+    {
+        if (run.repeat) memset(buffer + run.offset, pgm_read_byte(run.data), run.length);
+        else memcpy_P(buffer + run.offset, run.data, run.length);
+    }
+    return true;
+}
@@ -1,357 +1,443 @@
 #include <Arduino.h>
 
-// SSD1306 Interfacing libraries
-#include <SPI.h>
-#include <Wire.h>
-#include <Adafruit_SSD1306.h>
-
-// Graphics libraries
-#include <Adafruit_GFX.h>
-// Custom fireworks animation library
-#include <fireworks_ssd1306.h>
-
-// Pin definitions
-#define UP_BUTTON       6
-#define DOWN_BUTTON     7
-
-// Screen definition (w/h in pixels, reset pin -1 -> same as Arduino)
-#define SCREEN_WIDTH  128
-#define SCREEN_HEIGHT  64
+// Custom fireworks animation library (compressed frames, see tools/encode_fireworks.py)
+#include <fireworks.h>
+// SSD1306 display with dirty region tracking and partial flushes (also picks I2C or SPI)
+#include <pong_display.h>
+// Fixed-timestep game simulation
+#include <pong_sim.h>
+// Every screen, drawn into the RAM buffer or the page renderer's display list
+#include <pong_render.h>
+// Compile-time positions of the fixed UI text
+#include <pong_layout.h>
+// Interrupt-driven, debounced buttons (also defines the button pins)
+#include <pong_input.h>
+// Background panel transfers for rally frames (see PongDisplay::flushAsync)
+#include <pong_twi.h>
+// Frame, flush, bus and input latency counters over Serial (-DPONG_TELEMETRY=0 removes them)
+#include <pong_telemetry.h>
+// Match traces (seed and inputs) in EEPROM, replayed tick for tick (-DPONG_RECORD=0 removes them)
+#include <pong_record.h>
+// Timer1-driven deadlines for the input, physics, render, serial and record tasks
+#include <pong_sched.h>
+
+// Screen reset pin (-1 -> same as Arduino), the size comes from pong_sim.h
 #define OLED_RESET     -1
 
+// Game modes, advanced from loop() by input and scheduler deadlines so nothing ever blocks
+enum GameMode : uint8_t
+{
+    MODE_MENU,          // Waiting for a button press
+    MODE_SERVE,         // Short pause before the court is drawn and the rally starts
+    MODE_RALLY,         // Simulation running
+    MODE_GOAL_BANNER,   // Goal and scoreboard on screen
+    MODE_VICTORY        // Fireworks (if the player won), then the winner banner
+};
+
 // Function definitions
-bool refreshBall(unsigned long time);
-bool refreshPaddles(unsigned long time);
-void goal(String winner);
-void victoryScreen(String winner);
+void enterMode(GameMode next, SchedTime now);
+void updateInput();
+void updateMenu(SchedTime now);
+void updateServe(SchedTime now);
+void updateRally(SchedTime now);
+void updateGoalBanner(SchedTime now);
+void updateVictory(SchedTime now);
+bool runTicks(uint8_t ticks, SchedTime now);
+void pollSerial(SchedTime now);
+bool startReplay(SchedTime now);
+void reportReplay();
 void renderMenu();
+void renderRally();
+void renderGoalBanner(UiTextId headline);
+void renderVictoryBanner(UiTextId headline);
 
 // Game variables
-const unsigned int WIN_SCORE =               5; // Score required to win a match
-const unsigned long PADDLE_UPDATE_DELAY =    1; // Delay between paddle updates (ms)
-const unsigned long BALL_UPDATE_DELAY =      1; // Delay between ball updates (ms)
-const uint8_t PADDLE_LENGTH =               12; // Length of both paddles
-unsigned int DIFFICULTY =                   30; // CPU paddle difficulty setting (min 0, max 127)
-bool gameState =                         false; // Game state variable for menu implementation
-
-// Ball variables
-uint8_t ball_x =    64, ball_y =    32; // Position
-uint8_t ball_dir_x = 1, ball_dir_y = 1; // Direction
-uint8_t new_x, new_y;                   // Updated position placeholders
-unsigned long ball_update;
-
-// CPU Paddle variables
-unsigned long paddle_update;
-const uint8_t CPU_X = 12;
-uint8_t cpu_y =       16;
-
-// Player Paddle variables
-const uint8_t PLAYER_X = 115;
-uint8_t       player_y =  16;
-
-// Player Control input state booleans
+const unsigned int WIN_SCORE =                       5; // Score required to win a match
+const SchedTime INPUT_PERIOD =             SCHED_MS(1); // Delay between button checks
+const SchedTime TICK_PERIOD =              SCHED_MS(1); // Delay between simulation ticks
+const SchedTime RENDER_PERIOD =            SCHED_MS(4); // Delay between display refreshes
+const SchedTime SERIAL_PERIOD =           SCHED_MS(10); // Delay between Serial command checks
+const SchedTime RECORD_PERIOD =            SCHED_MS(4); // Delay between trace bytes saved to EEPROM (3.3 ms writes)
+const uint8_t MAX_CATCHUP_TICKS =                    8; // Most ticks run in one loop pass before dropping time
+const SchedTime FIREWORKS_FRAME_PERIOD = SCHED_MS(100); // Delay between victory animation frames
+const SchedTime MENU_SERVE_DELAY =       SCHED_MS(150); // Play button flash before the first serve
+const SchedTime BANNER_DELAY =          SCHED_MS(2000); // Time goal and victory banners stay on screen
+const SchedTime STARTUP_DELAY =         SCHED_MS(1000); // Blank screen at power up
+const SchedTime MENU_POWER_DOWN_DELAY = SCHED_MS(5000); // Idle menu time before powering down
+const unsigned long SERIAL_BAUD =               115200; // Telemetry and trace commands
+
+// Current mode and when it was entered
+GameMode mode = MODE_MENU;
+SchedTime mode_since;
+SchedTime serve_delay;
+SchedTime menu_active;                  // Last button or Serial activity in the menu
+
+// Simulation state, and what the display currently shows of it
+PongState state;
+RallyView rally_view;
+PongEvent last_goal = EVENT_NONE;       // Who scored last
+bool replaying = false;                 // Ticks take their inputs from the saved trace
+
+// Victory animation playback
+FireworksDecoder fireworks;
+bool fireworks_playing = false;
+
+// Player Control input state booleans: set by presses and held buttons, cleared once a tick used them
 static bool   up_state = false;
 static bool down_state = false;
 
-// Half paddle length (constant)
-const uint8_t half_paddle = PADDLE_LENGTH / 2;
-
-// Setup text centering value storage
-int16_t centercursorx, centercursory; uint16_t centerwidth, centerheight;
-
-// Scorekeeping
-unsigned int cpu_score, player_score = 0;
-
+#if PONG_DISPLAY_SPI
+// Declaration for an SSD1306 display connected to hardware SPI (MOSI, SCK, DC and CS pins)
+PongDisplay display(PanelSPI(OLED_DC, OLED_RESET, OLED_CS));
+#else
 // Declaration for an SSD1306 display connected to I2C (SDA, SCL pins)
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+PongDisplay display(PanelI2C(OLED_RESET));
+#endif
 
 void setup() {
-    // Initialize display, splash adafruit logo briefly
+    // Initialize display with a blank screen
     display.begin(SSD1306_SWITCHCAPVCC, 0x3C);
     display.display();
-    unsigned long start = millis();
-    delay(500);
-    display.clearDisplay();
-    display.display();
 
-    // Setup text rendering
-    display.setTextSize(1);
-    display.setTextColor(WHITE);
-    display.setTextWrap(false);
+    // Scheduler clock
+    schedBegin();
+    SchedTime start = schedNow();
 
-    // Input pin assignment
-    pinMode(UP_BUTTON, INPUT);
-    pinMode(DOWN_BUTTON, INPUT);
+    // Input pins and their pin change interrupt
+    inputBegin();
 
-    // Enable internal pull-up resistor on input pins
-    digitalWrite(UP_BUTTON,1);
-    digitalWrite(DOWN_BUTTON,1);
+    // Counters and traces, and their Serial commands
+#if PONG_TELEMETRY || PONG_RECORD
+    Serial.begin(SERIAL_BAUD);
+#endif
+    telemetryBegin();
 
     // 1 second buffer before continuing
-    while(millis() - start < 1000);
+    while (schedSince(schedNow(), start) < STARTUP_DELAY);
 
-    // Set paddle and ball refresh counters before beginning game logic
-    paddle_update = ball_update = millis();
+    // Tasks that run in every mode; the mode starts its own
+    SchedTime now = schedNow();
+    schedStart(TASK_INPUT, INPUT_PERIOD, now);
+    schedStart(TASK_SERIAL, SERIAL_PERIOD, now);
+
+    // Both buttons held at power up replay the last saved match
+    if (inputHeld() == (INPUT_UP | INPUT_DOWN) && startReplay(now)) return;
+    enterMode(MODE_MENU, now);
 }
 
 void loop() {
-    if (!gameState)
+    // Start a queued panel transfer (or keep it moving when pong_twi polls)
+    twiService();
+
+    // Refresh the scheduler clock, then run the tasks that are due
+    SchedTime now = schedNow();
+
+    if (schedDue(TASK_INPUT, now)) updateInput();
+    if (schedDue(TASK_SERIAL, now)) pollSerial(now);
+    if (schedDue(TASK_RECORD, now) && !recordService()) schedStop(TASK_RECORD);
+
+    switch (mode)
     {
-        renderMenu();
+    case MODE_MENU:         updateMenu(now);        break;
+    case MODE_SERVE:        updateServe(now);       break;
+    case MODE_RALLY:        updateRally(now);       break;
+    case MODE_GOAL_BANNER:  updateGoalBanner(now);  break;
+    case MODE_VICTORY:      updateVictory(now);     break;
     }
 
-    // Reset update and control booleans, refresh real-time counter
-    bool update = false;
-    unsigned long time = millis();
-    
-    // Update player control states
-    up_state |= (digitalRead(UP_BUTTON) == LOW);
-    down_state |= (digitalRead(DOWN_BUTTON) == LOW);
-
-    // Request an update if either the ball or paddles are due for a refresh
-    update = refreshBall(time) | refreshPaddles(time);
-    // Bitwise OR operator '|' used above since the normal '||' OR operator will
-    // simply ignore the second condition to save time, if the first condition returns 'true'
-
-    // Refresh display whenever requested
-    if(update && gameState)
+    // Nothing due: sleep until the next interrupt (a scheduler tick at the latest)
+    schedIdle();
+}
+
+// Switch modes, drawing whatever the new mode shows first
+void enterMode(GameMode next, SchedTime now)
+{
+    if (mode == MODE_RALLY) telemetryCancelInput();
+    mode = next;
+    mode_since = now;
+
+    // Rally and victory start their own tasks
+    schedStop(TASK_PHYSICS);
+    schedStop(TASK_RENDER);
+
+    switch (mode)
     {
-        display.display();
+    case MODE_MENU:
+        renderMenu();
+        up_state = down_state = false;
+        menu_active = now;
+        break;
+    case MODE_RALLY:
+        schedStart(TASK_PHYSICS, TICK_PERIOD, now);
+        schedStart(TASK_RENDER, RENDER_PERIOD, now + RENDER_PERIOD);
+        break;
+    case MODE_GOAL_BANNER:
+        renderGoalBanner(last_goal == EVENT_PLAYER_GOAL ? UI_PLAYER_SCORES : UI_CPU_SCORES);
+        break;
+    case MODE_VICTORY:
+        // The match is over: check a replay against the original, or keep the new trace
+        if (replaying)
+        {
+            reportReplay();
+        }
+        else
+        {
+            recordSave(state);
+            schedStart(TASK_RECORD, RECORD_PERIOD, now);
+        }
+
+        // Pull graphics from fireworks library and run an animation frame by frame if the player won
+        // (the animation is 128x64)
+        fireworks_playing = last_goal == EVENT_PLAYER_GOAL && SCREEN_HEIGHT == 64;
+        if (fireworks_playing)
+        {
+            fireworksBegin(fireworks);
+            schedStart(TASK_RENDER, FIREWORKS_FRAME_PERIOD, now);
+        }
+        else
+        {
+            renderVictoryBanner(last_goal == EVENT_PLAYER_GOAL ? UI_PLAYER_WINS : UI_CPU_WINS);
+        }
+        break;
+    default:
+        break;
     }
 }
 
-// Render main menu
-void renderMenu()
+// Update player control states, in every mode. Presses queued by the interrupt count even
+// if the button was released again before this pass; held buttons keep counting.
+void updateInput()
 {
-    display.clearDisplay();
-    display.drawRect(0, 0, 128, 64, WHITE);
-
-    // Different text style for menu
-    display.setTextSize(2);
-    // Render the play button in a box
-    display.getTextBounds(String("Play"), 0, 0, &centercursorx, &centercursory, &centerwidth, &centerheight);
-    display.setCursor((SCREEN_WIDTH-centerwidth)/2, (SCREEN_HEIGHT-centerheight)/2);
-    display.println("Play");
-    display.drawRect(((SCREEN_WIDTH-centerwidth)/2) - 5, ((SCREEN_HEIGHT-centerheight)/2) - 5, centerwidth + 10, centerheight + 10, WHITE);
-    // Render help text
-    display.setTextSize(1);
-    display.getTextBounds(String("[press any button]"), 0, 0, &centercursorx, &centercursory, &centerwidth, &centerheight);
-    display.setCursor((SCREEN_WIDTH-centerwidth)/2, (SCREEN_HEIGHT/2)+20);
-    display.println("[press any button]");
+    inputService(millis());
+    InputEvent event;
+    while (inputPop(event))
+    {
+        if (!event.pressed) continue;
+        if (mode == MODE_RALLY) telemetryInput(event.time);
+        if (event.button == INPUT_UP) up_state = true;
+        else down_state = true;
+    }
+    uint8_t held = inputHeld();
+    up_state |= (held & INPUT_UP) != 0;
+    down_state |= (held & INPUT_DOWN) != 0;
+}
 
-    display.display();
-    
-    while (!(digitalRead(UP_BUTTON) == LOW) && !(digitalRead(DOWN_BUTTON) == LOW))
+// Start a match on any button press, power down after a while without one
+void updateMenu(SchedTime now)
+{
+    if (!up_state && !down_state)
     {
-        // do absolutely nothing
+        if (schedSince(now, menu_active) < MENU_POWER_DOWN_DELAY) return;
+
+        // Only a button wakes it up: let pending Serial output finish first
+#if PONG_TELEMETRY || PONG_RECORD
+        Serial.flush();
+#endif
+        schedPowerDown();
+        menu_active = schedNow();
+        return;
     }
+    up_state = down_state = false;
 
-    // Invert the play button colors for a second as a reaction (same code, opposite colors)
-    display.setTextSize(2);
-    display.setTextColor(BLACK);
-    display.getTextBounds(String("Play"), 0, 0, &centercursorx, &centercursory, &centerwidth, &centerheight);
-    display.fillRect(((SCREEN_WIDTH-centerwidth)/2) - 5, ((SCREEN_HEIGHT-centerheight)/2) - 5, centerwidth + 10, centerheight + 10, WHITE);
-    display.setCursor((SCREEN_WIDTH-centerwidth)/2, (SCREEN_HEIGHT-centerheight)/2);
-    display.println("Play");
+    // Invert the play button colors for a moment as a reaction
+    drawMenuPress(display);
     display.display();
-    delay(150);
 
-    // Reset display properties
-    display.setTextSize(1);
-    display.setTextColor(WHITE);
-    display.clearDisplay();
+    // New match, seeded from the moment the button was pressed
+    pongReset(state, micros());
+    recordBegin(state);
+    serve_delay = MENU_SERVE_DELAY;
+    enterMode(MODE_SERVE, now);
+}
+
+// Draw the court once the serve delay is over, then start the rally
+void updateServe(SchedTime now)
+{
+    if (schedSince(now, mode_since) < serve_delay) return;
 
-    // Set game state
-    gameState = true;
+    drawCourt(display, rally_view);
 
-    // Draw court
-    display.drawRect(0, 0, 128, 64, WHITE);
+    up_state = down_state = false;
+    enterMode(MODE_RALLY, now);
 }
 
-// Update ball location
-bool refreshBall(unsigned long time)
+void updateRally(SchedTime now)
 {
-    if(time > ball_update)
+    // Advance the simulation to the current time, stop at a goal
+    uint8_t ticks = schedDue(TASK_PHYSICS, now, MAX_CATCHUP_TICKS);
+    if (ticks && runTicks(ticks, now))
     {
-        // Move ball to next location
-        new_x = ball_x + ball_dir_x;
-        new_y = ball_y + ball_dir_y;
+        enterMode(MODE_GOAL_BANNER, now);
+        return;
+    }
+    if (mode != MODE_RALLY) return;     // The replayed trace ran out
 
-        // Check for a vertical wall collision, consequently call a goal
-        if(new_x == 0)
-        {
-            goal("PLAYER"); // Player scored a goal
-        }
-        else if(new_x == 127)
-        {
-            goal("CPU"); // CPU scored a goal
-        }
+    // Refresh display once per render period and only when the game moved,
+    // pushing only the pages/columns that changed
+    if (schedDue(TASK_RENDER, now) && state.tick != rally_view.drawn.tick)
+    {
+        renderRally();
+    }
+}
 
-        // Logic for paddle and top/bottom wall collisions:
-        // Inverse the direction of the ball in x or y directions respectively, maintain the other direction
+// After the banner, either serve again or celebrate a match win
+void updateGoalBanner(SchedTime now)
+{
+    if (schedSince(now, mode_since) < BANNER_DELAY) return;
 
-        // Check for a horizontal wall collision
-        if(new_y == 0 || new_y == 63)
-        {
-            ball_dir_y = -ball_dir_y;
-            new_y += ball_dir_y + ball_dir_y;
-        }
+    if (state.player_score >= WIN_SCORE || state.cpu_score >= WIN_SCORE)
+    {
+        enterMode(MODE_VICTORY, now);
+    }
+    else
+    {
+        serve_delay = 0;
+        enterMode(MODE_SERVE, now);
+    }
+}
 
-        // Check for a CPU Paddle collision
-        if(new_x == CPU_X && new_y >= cpu_y && new_y <= cpu_y + PADDLE_LENGTH)
-        {
-            ball_dir_x = -ball_dir_x;
-            new_x += ball_dir_x + ball_dir_x;
-        }
+void updateVictory(SchedTime now)
+{
+    if (fireworks_playing)
+    {
+        if (!schedDue(TASK_RENDER, now)) return;
 
-        // Check for a Player Paddle collision
-        if(new_x == PLAYER_X && new_y >= player_y && new_y <= player_y + PADDLE_LENGTH)
+        // Only the bytes that differ from the previous frame are streamed to the panel,
+        // straight from PROGMEM
+        if (fireworksNextFrame(fireworks))
         {
-            ball_dir_x = -ball_dir_x;
-            new_x += ball_dir_x + ball_dir_x;
+            FireworksRun run;
+            display.beginPanelWrite();
+            while (fireworksNextRun(fireworks, run))
+            {
+                display.writePanel_P(run.offset, run.data, run.length, run.repeat);
+            }
+            display.endPanelWrite();
+            return;
         }
 
-        // Clear old ball and draw new ball on the updated location
-        display.drawPixel(ball_x, ball_y, BLACK);
-        display.drawPixel(new_x, new_y, WHITE);
-        ball_x = new_x;
-        ball_y = new_y;
-
-        ball_update += BALL_UPDATE_DELAY;
-        
-        // Set update boolean to true to force display update
-        return true;
+        // Animation over, banner time starts now
+        fireworks_playing = false;
+        mode_since = now;
+        renderVictoryBanner(UI_PLAYER_WINS);
+        return;
     }
-    return false;
+
+    // Reset scores and send player back to menu
+    if (schedSince(now, mode_since) < BANNER_DELAY) return;
+    state.player_score = state.cpu_score = 0;
+    enterMode(MODE_MENU, now);
 }
 
-// Update paddle positions
-bool refreshPaddles(unsigned long time)
+// Run the simulation ticks that are due (the scheduler has already dropped any beyond the
+// catch-up budget). Returns true if a goal was scored (the simulation has already served again).
+bool runTicks(uint8_t ticks, SchedTime now)
 {
-    if (time > paddle_update)
+    uint8_t ran = 0;
+    bool scored = false;
+    PongInputs inputs = { up_state, down_state };
+    while (ran < ticks)
     {
-        // Clear old CPU Paddle
-        display.drawFastVLine(CPU_X, cpu_y, PADDLE_LENGTH, BLACK);
-        // Move CPU Paddle based on the y coordinate of the ball
-        // The difficulty setting limits the horizontal proximity in which the CPU can 'see' the ball and move the paddle in response to it (max = 127, min 0)
-        // CPU paddle also gives up if the ball is already behind its paddle
-        if (ball_x < DIFFICULTY && ball_x >= 12)
+        ran++;
+        twiService();
+
+        if (replaying)
         {
-            if(cpu_y + half_paddle > ball_y) {
-                cpu_y -= 1;
-            }
-            if(cpu_y + half_paddle < ball_y) {
-                cpu_y += 1;
+            if (!replayNext(inputs))
+            {
+                reportReplay();
+                enterMode(MODE_MENU, now);
+                return false;
             }
         }
-        // Boundary implementation
-        if(cpu_y < 1) cpu_y = 1;
-        if(cpu_y + PADDLE_LENGTH > 63) cpu_y = 63 - PADDLE_LENGTH;
-        // Draw new CPU Paddle
-        display.drawFastVLine(CPU_X, cpu_y, PADDLE_LENGTH, WHITE);
-
-        // Clear old Player Paddle
-        display.drawFastVLine(PLAYER_X, player_y, PADDLE_LENGTH, BLACK);
-        // Move Player Paddle based on the control state
-        if(up_state) {
-            player_y -= 1;
+        else
+        {
+            recordTick(state, inputs);
         }
-        if(down_state) {
-            player_y += 1;
+
+        PongEvent event = pongStep(state, inputs);
+        if (event != EVENT_NONE)
+        {
+            last_goal = event;
+            scored = true;
+            break;
         }
-        // Reset input state variables
-        up_state = down_state = false;
-        // Boundary implementation
-        if(player_y < 1) player_y = 1;
-        if(player_y + PADDLE_LENGTH > 63) player_y = 63 - PADDLE_LENGTH;
-        // Draw new CPU Paddle
-        display.drawFastVLine(PLAYER_X, player_y, PADDLE_LENGTH, WHITE);
+    }
 
-        paddle_update += PADDLE_UPDATE_DELAY;
+    telemetryTicks(ran);
 
-        // Set update boolean to true to force display update
-        return true;
-    }
-    return false;
+    // Reset input state variables once they were applied
+    up_state = down_state = false;
+    return scored;
 }
 
-// Goal scorekeeping and celebration screen
-void goal(String winner)
+// Serial commands: 'd' prints the trace of the current match, 'p' replays the saved one
+// (from the menu), the rest go to the telemetry
+void pollSerial(SchedTime now)
 {
-    // Clear court area
-    display.fillRect(1, 1, 126, 62, BLACK);
-    if (winner != "CPU")
-    {
-        // Player goal
-        player_score += 1;
-    }
-    else
-    {
-        // CPU goal
-        cpu_score += 1;
-    }
-
-    // Animation and scoreboard display
-    display.getTextBounds(String(winner + " SCORES!"), 0, 0, &centercursorx, &centercursory, &centerwidth, &centerheight);
-    display.setCursor((SCREEN_WIDTH-centerwidth)/2, ((SCREEN_HEIGHT-centerheight)/2) - 10);
-    display.println(winner + " SCORES!");
-    String scoreboard = "[CPU " + String(cpu_score) + " : " + String(player_score) + " PLAYER]";
-    display.getTextBounds(scoreboard, 0, 0, &centercursorx, &centercursory, &centerwidth, &centerheight);
-    display.setCursor((SCREEN_WIDTH-centerwidth)/2, ((SCREEN_HEIGHT-centerheight)/2) + 8);
-    display.println(scoreboard);
-    display.display();
-    delay(2000);
-    display.clearDisplay();
+#if PONG_TELEMETRY || PONG_RECORD
+    if (!Serial.available()) return;
 
-    // If score passes some max value, display cooler animation and offer a replay
-    if (player_score >= WIN_SCORE || cpu_score >= WIN_SCORE)
+    char command = Serial.read();
+    menu_active = now;
+    switch (command)
     {
-        victoryScreen(winner);
-        player_score = cpu_score = 0;
+    case 'd': recordDump(state); break;
+    case 'p': if (mode == MODE_MENU) startReplay(now); break;
+    default: telemetryCommand(command); break;
     }
+#else
+    (void)now;
+#endif
+}
 
-    // Reset court and ball
-    display.clearDisplay();
-    display.drawRect(0, 0, 128, 64, WHITE);
-    ball_x = 64, ball_y = 32;
+// Load the trace saved in EEPROM and play it like a live match, the buttons ignored
+bool startReplay(SchedTime now)
+{
+    if (!replayBegin(state)) return false;
 
-    // Random direction for the reset ball (-1/1 for both x and y)
-    ball_dir_x = (-1 + 2*(rand() % 2)), ball_dir_y = (-1 + 2*(rand() % 2));
-    new_x = ball_x + ball_dir_x;
-    new_y = ball_y + ball_dir_y;
+    replaying = true;
+    serve_delay = MENU_SERVE_DELAY;
+    enterMode(MODE_SERVE, now);
+    return true;
+}
 
-    // Reset paddles
-    player_y = cpu_y = 16;
+// The replay is over: say whether it ended where the recorded match did
+void reportReplay()
+{
+    replaying = false;
+#if PONG_RECORD
+    Serial.println(replayMatches(state) ? F("replay ok") : F("replay diverged"));
+#endif
+}
 
-    // Randomize CPU difficulty
-    DIFFICULTY = 12+(rand() % 43);
+// Render main menu
+void renderMenu()
+{
+    drawMenu(display);
+    display.display();
 }
 
-void victoryScreen(String winner)
+// Draw the ball and paddles where the simulation put them, erasing their old positions
+void renderRally()
 {
-    // IF player won:
-    // Pull graphics from fireworks library and run an animation frame by frame
-    if (winner != "CPU")
-    {
-        for (int i = 0; i < e_allArray_LEN; i++)
-        {
-            display.clearDisplay();
-            display.drawRect(0, 0, 128, 64, WHITE);
-            display.drawBitmap(0, 0, e_allArray[i], SCREEN_WIDTH, SCREEN_HEIGHT, 1);
-            display.display();
-            delay(100);
-        }
-    }
-    display.clearDisplay();
-    display.drawRect(0, 0, 128, 64, WHITE);
+    drawRally(display, rally_view, state);
+
+    // Hand the changes to the background transfer; while the previous frame is still on the
+    // bus they stay dirty and go out with the next one
+    if (display.flushAsync()) telemetryFrame(millis());
+}
 
-    // Animation and scoreboard display
-    display.getTextBounds(String(winner + " WINS!"), 0, 0, &centercursorx, &centercursory, &centerwidth, &centerheight);
-    display.setCursor((SCREEN_WIDTH-centerwidth)/2, (SCREEN_HEIGHT-centerheight)/2);
-    display.println(winner + " WINS!");
+// Goal celebration screen (the simulation has already updated the score)
+void renderGoalBanner(UiTextId headline)
+{
+    drawGoalBanner(display, headline, state.cpu_score, state.player_score);
     display.display();
-    delay(2000);
+}
 
-    // Reset game state to send player back to menu
-    gameState = false;
-}
\ No newline at end of file
+// Match winner screen
+void renderVictoryBanner(UiTextId headline)
+{
+    drawVictoryBanner(display, headline);
+    display.display();
+}
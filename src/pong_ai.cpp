@@ -0,0 +1,72 @@
+#include <pong_ai.h>
+#include <pong_sim.h>
+
+// Paddle top positions that keep the paddle inside the court
+const uint8_t CPU_MIN_Y = 1;
+const uint8_t CPU_MAX_Y = COURT_HEIGHT - 1 - PADDLE_LENGTH;
+
+void aiSetLevel(PongAI &ai, uint8_t level)
+{
+    if (level > AI_MAX_LEVEL) level = AI_MAX_LEVEL;
+    ai.level = level;
+
+    // Level 0: 60 ticks late, 0.5 px/tick, up to 7 px off (more than half a paddle).
+    // Top level: 18 ticks late, 0.99 px/tick, 1 px off.
+    ai.reaction = 60 - level;
+    ai.speed = 128 + 3 * level;
+    ai.aim_error = 7 - level / 7;
+
+    ai.wait = 0;
+    ai.travel = 0;
+}
+
+// Row (pixel) at which the ball will reach the CPU paddle face, folding its straight path
+// back into the court at every wall it would bounce off on the way
+static uint8_t predictIntercept(const PongState &state)
+{
+    int32_t ticks = ((int32_t)(state.ball_x - CPU_PADDLE_FACE) << FIXED_SHIFT) / -state.ball_vx;
+    int32_t span = BALL_MAX_Y - BALL_MIN_Y;
+    int32_t y = (state.ball_y - BALL_MIN_Y) + (((int32_t)state.ball_vy * ticks) >> FIXED_SHIFT);
+
+    y %= 2 * span;
+    if (y < 0) y += 2 * span;
+    if (y > span) y = 2 * span - y;
+    return toPixel(BALL_MIN_Y + y);
+}
+
+void aiPlan(PongState &state)
+{
+    PongAI &ai = state.ai;
+    int16_t target;
+    if (state.ball_vx < 0 && state.ball_x >= CPU_PADDLE_FACE)
+    {
+        // Aim the paddle center at the intercept, off by up to aim_error either way
+        target = predictIntercept(state) - half_paddle;
+        target += (int16_t)(pongRandom(state) % (2 * ai.aim_error + 1)) - ai.aim_error;
+    }
+    else
+    {
+        target = COURT_HEIGHT / 2 - half_paddle;
+    }
+
+    if (target < CPU_MIN_Y) target = CPU_MIN_Y;
+    if (target > CPU_MAX_Y) target = CPU_MAX_Y;
+    ai.target_y = target;
+    ai.wait = ai.reaction;
+}
+
+void aiStep(PongState &state)
+{
+    PongAI &ai = state.ai;
+    if (ai.wait)
+    {
+        ai.wait--;
+        return;
+    }
+    if (state.cpu_y == ai.target_y) return;
+
+    ai.travel += ai.speed;
+    if (ai.travel < TICK_FRACTION) return;
+    ai.travel -= TICK_FRACTION;
+    state.cpu_y += state.cpu_y < ai.target_y ? 1 : -1;
+}
@@ -0,0 +1,357 @@
+#include <pong_display.h>
+#include <pong_telemetry.h>
+#include <pong_twi.h>
+
+#if PONG_PAGE_RENDER && PONG_SNAPSHOT_BYTES < 128
+#error "The page renderer rasterizes whole pages into the snapshot (PONG_SNAPSHOT_BYTES >= 128)"
+#endif
+
+// Member definitions of Display, compiled for PongDisplay at the end of the file
+
+#define DISPLAY_TEMPLATE    template <uint8_t W, uint8_t H, class Transport>
+#define DISPLAY             Display<W, H, Transport>
+
+DISPLAY_TEMPLATE
+DISPLAY::Display(const Transport &bus)
+    : bus(bus), twi_errors(0)
+{
+    clearDirty();
+#if PONG_PAGE_RENDER
+    item_count = 0;
+#endif
+}
+
+DISPLAY_TEMPLATE
+void DISPLAY::begin(uint8_t vcs, uint8_t address)
+{
+    bus.begin(address ? address : (H == 32 ? 0x3C : 0x3D));
+    clearDisplay();
+
+    beginPanelWrite();
+    bus.start(W, H, vcs);
+    endPanelWrite();
+}
+
+DISPLAY_TEMPLATE
+void DISPLAY::clearDisplay()
+{
+#if PONG_PAGE_RENDER
+    item_count = 0;
+#else
+    memset(buffer, 0, sizeof(buffer));
+#endif
+    markAllDirty();
+}
+
+DISPLAY_TEMPLATE
+void DISPLAY::display()
+{
+    twiFinish();
+#if PONG_TELEMETRY
+    unsigned long start = micros();
+#endif
+    bus.beginWrite();
+
+    // One address window for the whole panel, then one transfer per page
+    bus.setWindow(0, PAGES - 1, 0, W - 1);
+    for (uint8_t page = 0; page < PAGES; page++)
+    {
+        bus.sendData(spanPixels(page, 0, W - 1, snapshot), W, 0);
+    }
+
+    bus.endWrite();
+    clearDirty();
+#if PONG_TELEMETRY
+    telemetryFlush(micros() - start);
+#endif
+}
+
+DISPLAY_TEMPLATE
+void DISPLAY::markAllDirty()
+{
+    memset(dirty, 0xFF, sizeof(dirty));
+}
+
+DISPLAY_TEMPLATE
+void DISPLAY::clearDirty()
+{
+    memset(dirty, 0, sizeof(dirty));
+}
+
+// Mark columns x0..x1 (inclusive, unclipped) of one page
+DISPLAY_TEMPLATE
+void DISPLAY::markDirty(int16_t x0, int16_t x1, int16_t page)
+{
+    if (x0 < 0) x0 = 0;
+    if (x1 >= W) x1 = W - 1;
+    if (x0 > x1) return;
+
+    for (uint8_t block = x0 >> DIRTY_BLOCK_SHIFT; block <= (x1 >> DIRTY_BLOCK_SHIFT); block++)
+    {
+        dirty[page][block >> 3] |= 1 << (block & 7);
+    }
+}
+
+// Mark every page span a box covers (unclipped)
+DISPLAY_TEMPLATE
+void DISPLAY::markBox(int16_t x, int16_t y, uint8_t w, uint8_t h)
+{
+    if (!w || !h) return;
+    int16_t y1 = y + h - 1;
+    if (y < 0) y = 0;
+    if (y1 >= H) y1 = H - 1;
+    for (int16_t page = y >> 3; page <= (y1 >> 3); page++)
+    {
+        markDirty(x, x + w - 1, page);
+    }
+}
+
+// Next run of dirty blocks at or after the cursor, with short clean gaps merged into it,
+// as a page and inclusive column range. Returns false when there are no more.
+DISPLAY_TEMPLATE
+bool DISPLAY::nextDirtyRun(DirtyCursor &cursor, uint8_t &page, uint8_t &col_start, uint8_t &col_end)
+{
+    const uint8_t blocks = (W + DIRTY_BLOCK_COLUMNS - 1) >> DIRTY_BLOCK_SHIFT;
+    for (; cursor.page < PAGES; cursor.page++, cursor.block = 0)
+    {
+        // Skip clean pages quickly
+        if (cursor.block == 0)
+        {
+            uint8_t any = 0;
+            for (uint8_t i = 0; i < DIRTY_MASK_BYTES; i++) any |= dirty[cursor.page][i];
+            if (!any) continue;
+        }
+
+        // Walk the block mask, coalescing dirty blocks into a run until a long enough gap
+        int16_t run_start = -1, run_end = -1;
+        for (uint8_t block = cursor.block; block < blocks; block++)
+        {
+            if (!(dirty[cursor.page][block >> 3] & (1 << (block & 7)))) continue;
+            if (run_start >= 0 && block - run_end - 1 > DIRTY_MERGE_GAP_BLOCKS) break;
+            if (run_start < 0) run_start = block;
+            run_end = block;
+        }
+        if (run_start < 0) continue;
+
+        int16_t end = ((run_end + 1) << DIRTY_BLOCK_SHIFT) - 1;
+        page = cursor.page;
+        col_start = run_start << DIRTY_BLOCK_SHIFT;
+        col_end = end < W ? end : W - 1;
+        cursor.block = run_end + 1;
+        return true;
+    }
+    return false;
+}
+
+DISPLAY_TEMPLATE
+void DISPLAY::flushDirty()
+{
+    twiFinish();
+#if PONG_TELEMETRY
+    unsigned long start = micros();
+#endif
+    bus.beginWrite();
+
+    DirtyCursor cursor = { 0, 0 };
+    uint8_t page, col_start, col_end;
+    while (nextDirtyRun(cursor, page, col_start, col_end))
+    {
+        sendWindow(page, col_start, col_end);
+    }
+
+    bus.endWrite();
+    clearDirty();
+#if PONG_TELEMETRY
+    telemetryFlush(micros() - start);
+#endif
+}
+
+DISPLAY_TEMPLATE
+bool DISPLAY::flushAsync()
+{
+    return flushQueued(bus);
+}
+
+DISPLAY_TEMPLATE
+bool DISPLAY::flushQueued(PanelSPI &spi)
+{
+    (void)spi;
+    flushDirty();
+    return true;
+}
+
+DISPLAY_TEMPLATE
+bool DISPLAY::flushQueued(PanelI2C &i2c)
+{
+    twiService();
+    if (twiBusy()) return false;
+
+    // A transfer the panel did not acknowledge left it out of date
+    if (twiErrors() != twi_errors)
+    {
+        twi_errors = twiErrors();
+        markAllDirty();
+    }
+
+    // Size the snapshot first; a dirty region too large for it goes out synchronously
+    DirtyCursor cursor = { 0, 0 };
+    uint8_t page, col_start, col_end;
+    uint16_t bytes = 0;
+    uint8_t transactions = 0;
+    while (nextDirtyRun(cursor, page, col_start, col_end))
+    {
+        bytes += PANEL_WINDOW_BYTES + col_end - col_start + 1;
+        transactions += 2;
+    }
+    if (!transactions) return true;
+    if (bytes > PONG_SNAPSHOT_BYTES || transactions > twiQueueSpace())
+    {
+        flushDirty();
+        return true;
+    }
+
+#if PONG_TELEMETRY
+    unsigned long start = micros();
+#endif
+
+    // Copy each window's commands and pixels, then let the transmitter run with them
+    twiBegin(i2c.address());
+    uint8_t *out = snapshot;
+    cursor.page = cursor.block = 0;
+    while (nextDirtyRun(cursor, page, col_start, col_end))
+    {
+        uint8_t *commands = out;
+        *out++ = SSD1306_PAGEADDR;
+        *out++ = page;
+        *out++ = page;
+        *out++ = SSD1306_COLUMNADDR;
+        *out++ = col_start;
+        *out++ = col_end;
+        twiQueue(SSD1306_CONTROL_COMMANDS, commands, PANEL_WINDOW_BYTES);
+
+        uint8_t length = col_end - col_start + 1;
+        const uint8_t *pixels = spanPixels(page, col_start, col_end, out);
+        if (pixels != out) memcpy(out, pixels, length);
+        twiQueue(SSD1306_CONTROL_DATA, out, length);
+        out += length;
+
+        // Address and control byte for each of the two transactions
+        telemetryBusBytes(PANEL_WINDOW_BYTES + length + 4);
+    }
+    clearDirty();
+    twiService();
+
+#if PONG_TELEMETRY
+    telemetryFlush(micros() - start);
+#endif
+    return true;
+}
+
+// Send one page span (the snapshot is free: nothing is on the bus during a blocking flush)
+DISPLAY_TEMPLATE
+void DISPLAY::sendWindow(uint8_t page, uint8_t col_start, uint8_t col_end)
+{
+    bus.setWindow(page, page, col_start, col_end);
+    bus.sendData(spanPixels(page, col_start, col_end, snapshot), col_end - col_start + 1, 0);
+}
+
+// Pixels of one page span: in the RAM buffer, or rasterized from the display list into
+// 'scratch' by the page renderer
+DISPLAY_TEMPLATE
+const uint8_t *DISPLAY::spanPixels(uint8_t page, uint8_t col_start, uint8_t col_end, uint8_t *scratch)
+{
+#if PONG_PAGE_RENDER
+    sceneRender(items, item_count, page, col_start, col_end, scratch);
+    return scratch;
+#else
+    (void)col_end;
+    (void)scratch;
+    return buffer + (uint16_t)page * W + col_start;
+#endif
+}
+
+DISPLAY_TEMPLATE
+void DISPLAY::beginPanelWrite()
+{
+    twiFinish();
+    bus.beginWrite();
+}
+
+DISPLAY_TEMPLATE
+void DISPLAY::writePanel_P(uint16_t offset, const uint8_t *data, uint8_t length, bool repeat)
+{
+    if (!length) return;
+
+    uint8_t page = offset / W;
+    uint8_t col_start = offset % W;
+    bus.setWindow(page, page, col_start, col_start + length - 1);
+    bus.sendData(data, length, PANEL_PROGMEM | (repeat ? PANEL_REPEAT : 0));
+}
+
+DISPLAY_TEMPLATE
+void DISPLAY::endPanelWrite()
+{
+    bus.endWrite();
+    markAllDirty();
+}
+
+#if PONG_PAGE_RENDER
+
+DISPLAY_TEMPLATE
+uint8_t DISPLAY::addItem(const SceneItem &item)
+{
+    if (item_count == SCENE_ITEMS) return SCENE_ITEMS;
+    items[item_count] = item;
+    markBox(item.x, item.y, item.w, item.h);
+    return item_count++;
+}
+
+DISPLAY_TEMPLATE
+void DISPLAY::moveItem(uint8_t slot, int16_t x, int16_t y)
+{
+    if (slot >= item_count) return;
+    SceneItem &item = items[slot];
+    if (item.x == x && item.y == y) return;
+
+    // A box sliding up or down its own columns only changes the pages where its rows differ
+    if (item.kind == SCENE_FILL && item.x == x && item.y >= 0 && y >= 0 && item.y + item.h <= H && y + item.h <= H)
+    {
+        uint8_t first = (item.y < y ? item.y : y) >> 3;
+        uint8_t last = ((item.y > y ? item.y : y) + item.h - 1) >> 3;
+        for (uint8_t page = first; page <= last; page++)
+        {
+            if (columnMask(page, item.y, item.h) != columnMask(page, y, item.h)) markDirty(x, x + item.w - 1, page);
+        }
+        item.y = y;
+        return;
+    }
+
+    markBox(item.x, item.y, item.w, item.h);
+    item.x = x;
+    item.y = y;
+    markBox(x, y, item.w, item.h);
+}
+
+#else
+
+// Paint the item into every page span it covers
+DISPLAY_TEMPLATE
+uint8_t DISPLAY::addItem(const SceneItem &item)
+{
+    int16_t x0 = item.x > 0 ? item.x : 0;
+    int16_t x1 = item.x + item.w - 1 < W - 1 ? item.x + item.w - 1 : W - 1;
+    int16_t y0 = item.y > 0 ? item.y : 0;
+    int16_t y1 = item.y + item.h - 1 < H - 1 ? item.y + item.h - 1 : H - 1;
+    if (x0 > x1 || y0 > y1) return SCENE_ITEMS;
+
+    for (uint8_t page = y0 >> 3; page <= (y1 >> 3); page++)
+    {
+        scenePaint(item, page, x0, x1, buffer + (uint16_t)page * W + x0);
+        markDirty(x0, x1, page);
+    }
+    return SCENE_ITEMS;
+}
+
+#endif
+
+template class Display<SCREEN_WIDTH, SCREEN_HEIGHT, PongBus>;
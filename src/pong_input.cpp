@@ -0,0 +1,130 @@
+#include <pong_input.h>
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#else
+#include <native_hal.h>
+#endif
+
+// Event ring buffer: the interrupt only writes 'queue_head', the main loop only writes
+// 'queue_tail'. Both are single bytes, so neither side ever needs to disable interrupts.
+static InputEvent queue[INPUT_QUEUE_SIZE];
+static volatile uint8_t queue_head = 0;
+static volatile uint8_t queue_tail = 0;
+
+// Debounce state, owned by the interrupt (inputService() masks it while it looks)
+static volatile uint8_t held = 0;           // Accepted level of each button
+static volatile uint8_t pending = 0;        // Buttons that changed inside their debounce window
+static unsigned long last_change[2];        // Time of the last accepted change, per button
+
+// Raw button levels as INPUT_UP/INPUT_DOWN bits, 1 = pressed
+static uint8_t readButtons()
+{
+#if defined(__AVR__)
+    uint8_t pins = ~PIND;
+    return ((pins >> 6) & 1 ? INPUT_UP : 0) | ((pins >> 7) & 1 ? INPUT_DOWN : 0);
+#else
+    return (nativeGetPin(UP_BUTTON) == LOW ? INPUT_UP : 0) | (nativeGetPin(DOWN_BUTTON) == LOW ? INPUT_DOWN : 0);
+#endif
+}
+
+static void pushEvent(unsigned long time, uint8_t button, bool pressed)
+{
+    uint8_t next = (queue_head + 1) & (INPUT_QUEUE_SIZE - 1);
+    if (next == queue_tail) return;
+
+    queue[queue_head].time = time;
+    queue[queue_head].button = button;
+    queue[queue_head].pressed = pressed;
+    queue_head = next;
+}
+
+// Pin change handler: accept level changes outside the debounce window as events
+static void pinChange()
+{
+    unsigned long time = millis();
+    uint8_t changed = readButtons() ^ held;
+    pending = 0;
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        uint8_t button = 1 << i;
+        if (!(changed & button)) continue;
+
+        if (time - last_change[i] < INPUT_DEBOUNCE_MS)
+        {
+            pending |= button;
+            continue;
+        }
+        last_change[i] = time;
+        held ^= button;
+        pushEvent(time, button, held & button);
+    }
+}
+
+#if defined(__AVR__)
+ISR(PCINT2_vect)
+{
+    pinChange();
+}
+#else
+static void nativePinChange(uint8_t pin)
+{
+    if (pin == UP_BUTTON || pin == DOWN_BUTTON) pinChange();
+}
+#endif
+
+void inputBegin()
+{
+    // Inputs with the internal pull-up resistor enabled
+    pinMode(UP_BUTTON, INPUT);
+    pinMode(DOWN_BUTTON, INPUT);
+    digitalWrite(UP_BUTTON, 1);
+    digitalWrite(DOWN_BUTTON, 1);
+
+    held = readButtons();
+    last_change[0] = last_change[1] = millis() - INPUT_DEBOUNCE_MS;
+
+#if defined(__AVR__)
+    PCMSK2 |= _BV(PCINT22) | _BV(PCINT23);
+    PCIFR = _BV(PCIF2);
+    PCICR |= _BV(PCIE2);
+#else
+    nativeAttachPinChange(nativePinChange);
+#endif
+}
+
+bool inputPop(InputEvent &event)
+{
+    uint8_t tail = queue_tail;
+    if (tail == queue_head) return false;
+
+    event = queue[tail];
+    queue_tail = (tail + 1) & (INPUT_QUEUE_SIZE - 1);
+    return true;
+}
+
+uint8_t inputHeld()
+{
+    return held;
+}
+
+void inputService(unsigned long time)
+{
+    if (!pending) return;
+
+    // A bounce may have settled on a new level without another edge to report it
+    noInterrupts();
+    uint8_t expired = 0;
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        if ((pending & (1 << i)) && time - last_change[i] >= INPUT_DEBOUNCE_MS) expired = 1;
+    }
+    if (expired) pinChange();
+    interrupts();
+}
+
+bool inputIdle()
+{
+    return queue_head == queue_tail && !held && !pending;
+}
@@ -0,0 +1,39 @@
+#include <pong_layout.h>
+
+// Fixed UI strings
+static const char TEXT_PLAY[] PROGMEM =             "Play";
+static const char TEXT_PRESS_ANY_BUTTON[] PROGMEM = "[press any button]";
+static const char TEXT_CPU_SCORES[] PROGMEM =       "CPU SCORES!";
+static const char TEXT_PLAYER_SCORES[] PROGMEM =    "PLAYER SCORES!";
+static const char TEXT_CPU_WINS[] PROGMEM =         "CPU WINS!";
+static const char TEXT_PLAYER_WINS[] PROGMEM =      "PLAYER WINS!";
+
+// Layout of a PROGMEM string array centered at row 'y'
+#define CENTERED(text, size, y) centeredText(text, TEXT_LENGTH(text), size, y)
+
+#if SCREEN_HEIGHT >= 64
+// Play button: size 2 text in the middle of the screen, help text below it
+static constexpr UiText PLAY_LAYOUT = CENTERED(TEXT_PLAY, 2, textCenterY(2));
+#define PLAY_BOX_MARGIN     5
+#define HELP_Y              ((SCREEN_HEIGHT / 2) + 20)
+#else
+// 128x32: size 1 play button above the middle, help text on the bottom line
+static constexpr UiText PLAY_LAYOUT = CENTERED(TEXT_PLAY, 1, textCenterY(1) - 4);
+#define PLAY_BOX_MARGIN     3
+#define HELP_Y              (SCREEN_HEIGHT - 10)
+#endif
+
+const UiText ui_text[UI_TEXT_COUNT] PROGMEM =
+{
+    PLAY_LAYOUT,                                                            // UI_PLAY
+    CENTERED(TEXT_PRESS_ANY_BUTTON, 1, HELP_Y),                             // UI_PRESS_ANY_BUTTON
+    CENTERED(TEXT_CPU_SCORES, 1, UI_HEADLINE_Y),                            // UI_CPU_SCORES
+    CENTERED(TEXT_PLAYER_SCORES, 1, UI_HEADLINE_Y),                         // UI_PLAYER_SCORES
+    CENTERED(TEXT_CPU_WINS, 1, UI_BANNER_Y),                                // UI_CPU_WINS
+    CENTERED(TEXT_PLAYER_WINS, 1, UI_BANNER_Y)                              // UI_PLAYER_WINS
+};
+
+const UiRect ui_rect[UI_RECT_COUNT] PROGMEM =
+{
+    boxAround(PLAY_LAYOUT, PLAY_BOX_MARGIN)                                 // UI_PLAY_BOX
+};
@@ -0,0 +1,129 @@
+#include <pong_panel.h>
+#include <pong_telemetry.h>
+
+// Largest Wire transaction (including the control byte), same limit Adafruit_SSD1306 uses
+#if defined(BUFFER_LENGTH)
+#define PONG_WIRE_MAX BUFFER_LENGTH
+#else
+#define PONG_WIRE_MAX 32
+#endif
+
+#if PONG_TWI_TRANSPORT
+// Send one transaction through pong_twi straight from its source and wait until it is done
+static void twiSend(uint8_t address, uint8_t control, const uint8_t *data, uint8_t length, uint8_t flags)
+{
+    twiBegin(address);
+    twiQueue(control, data, length, flags);
+    twiFinish();
+    telemetryBusBytes(length + 2);
+}
+#endif
+
+// Byte 'index' of a panel data source (PANEL_* flags)
+static inline uint8_t sourceByte(const uint8_t *data, uint8_t index, uint8_t flags)
+{
+    if (!(flags & PANEL_REPEAT)) data += index;
+    return flags & PANEL_PROGMEM ? pgm_read_byte(data) : *data;
+}
+
+// I2C
+
+void PanelI2C::begin(uint8_t address)
+{
+    i2c_address = address;
+#if PONG_TWI_TRANSPORT
+    // Every write goes through pong_twi, so Wire is never linked in
+    twiInit();
+#else
+    Wire.begin();
+#endif
+}
+
+void PanelI2C::beginWrite()
+{
+#if ARDUINO >= 157 && !PONG_TWI_TRANSPORT
+    Wire.setClock(PANEL_WIRE_CLOCK);
+#endif
+}
+
+void PanelI2C::endWrite()
+{
+#if ARDUINO >= 157 && !PONG_TWI_TRANSPORT
+    Wire.setClock(PANEL_WIRE_IDLE_CLOCK);
+#endif
+}
+
+void PanelI2C::sendCommands(const uint8_t *commands, uint8_t length)
+{
+#if PONG_TWI_TRANSPORT
+    twiSend(i2c_address, SSD1306_CONTROL_COMMANDS, commands, length, 0);
+#else
+    Wire.beginTransmission(i2c_address);
+    Wire.write((uint8_t)SSD1306_CONTROL_COMMANDS);
+    for (uint8_t i = 0; i < length; i++) Wire.write(commands[i]);
+    Wire.endTransmission();
+    telemetryBusBytes(length + 2);
+#endif
+}
+
+void PanelI2C::sendData(const uint8_t *data, uint8_t length, uint8_t flags)
+{
+#if PONG_TWI_TRANSPORT
+    twiSend(i2c_address, SSD1306_CONTROL_DATA, data, length, flags);
+#else
+    uint8_t sent = 0;
+    while (sent < length)
+    {
+        Wire.beginTransmission(i2c_address);
+        Wire.write((uint8_t)SSD1306_CONTROL_DATA);
+        uint8_t bytes = 1;
+        while (sent < length && bytes < PONG_WIRE_MAX)
+        {
+            Wire.write(sourceByte(data, sent++, flags));
+            bytes++;
+        }
+        Wire.endTransmission();
+        telemetryBusBytes(bytes + 1);
+    }
+#endif
+}
+
+// SPI
+
+void PanelSPI::begin(uint8_t address)
+{
+    (void)address;
+    pinMode(dc_pin, OUTPUT);
+    pinMode(cs_pin, OUTPUT);
+    digitalWrite(cs_pin, HIGH);
+    SPI.begin();
+}
+
+void PanelSPI::select(bool data)
+{
+    SPI.beginTransaction(settings);
+    digitalWrite(cs_pin, LOW);
+    digitalWrite(dc_pin, data ? HIGH : LOW);
+}
+
+void PanelSPI::deselect()
+{
+    digitalWrite(cs_pin, HIGH);
+    SPI.endTransaction();
+}
+
+void PanelSPI::sendCommands(const uint8_t *commands, uint8_t length)
+{
+    select(false);
+    for (uint8_t i = 0; i < length; i++) SPI.transfer(commands[i]);
+    deselect();
+    telemetryBusBytes(length);
+}
+
+void PanelSPI::sendData(const uint8_t *data, uint8_t length, uint8_t flags)
+{
+    select(true);
+    for (uint8_t i = 0; i < length; i++) SPI.transfer(sourceByte(data, i, flags));
+    deselect();
+    telemetryBusBytes(length);
+}
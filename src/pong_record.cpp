@@ -0,0 +1,406 @@
+#include <pong_record.h>
+
+#if PONG_RECORD
+
+#include <EEPROM.h>
+#include <pong_input.h>
+
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+#else
+#include <native_hal.h>
+#endif
+
+// Trace image layout (EEPROM and Serial dumps)
+#define RECORD_MAGIC_0      'P'
+#define RECORD_MAGIC_1      'R'
+#define RECORD_VERSION      1
+//   magic and version (3), starting state (31, field by field), starting buttons (1),
+//   end tick and random state (4 + 4), event count (1), events
+
+// Longest run one event byte can describe
+#define RECORD_RUN_MAX      63
+
+// Once the ring holds more events than this, the oldest are stepped into the starting state,
+// at most RECORD_DRAIN_STEPS ticks per recorded tick so no tick pays for a whole 63 tick run
+#define RECORD_DRAIN_FROM   (RECORD_EVENTS * 3 / 4)
+#define RECORD_DRAIN_STEPS  2
+
+// Trace: starting state and buttons, then the ring of event bytes
+static PongState start;
+static uint8_t start_inputs;
+static uint8_t events[RECORD_EVENTS];
+static uint8_t first = 0, count = 0;
+static uint8_t drained = 0;             // Ticks of the oldest event already in the starting state
+static bool recording = false;
+
+// Recorder: buttons of the last tick and how many ticks they lasted since the last event
+static uint8_t current;
+static uint8_t held;
+
+// Replayer: next event, ticks left on the current buttons, and a change due after them
+static uint8_t replay_index;
+static uint8_t replay_left;
+static uint8_t replay_inputs;
+static uint8_t replay_next;
+static bool replay_change;
+static uint32_t end_tick, end_rng;      // Where the loaded or saving trace ended
+
+// Saver: next step (0 invalidates the version byte, then the image from offset 3 on, the
+// header last) and the image length
+static uint16_t save_step;
+static uint16_t save_length;
+static bool saving = false;
+
+static uint8_t inputBits(const PongInputs &inputs)
+{
+    return (inputs.up ? INPUT_UP : 0) | (inputs.down ? INPUT_DOWN : 0);
+}
+
+static PongInputs bitInputs(uint8_t bits)
+{
+    PongInputs inputs = { (bits & INPUT_UP) != 0, (bits & INPUT_DOWN) != 0 };
+    return inputs;
+}
+
+static uint8_t eventAt(uint8_t index)
+{
+    return events[(first + index) % RECORD_EVENTS];
+}
+
+// Step the oldest events into the starting state and forget them, a few ticks at a time,
+// until the ring is back under RECORD_DRAIN_FROM. A partly stepped event keeps its byte; the
+// image stores it with the stepped ticks taken off its run.
+static void drain()
+{
+    PongInputs inputs = bitInputs(start_inputs);
+    uint8_t steps = 0;
+    while (count > RECORD_DRAIN_FROM)
+    {
+        uint8_t event = eventAt(0);
+        if (drained < (event >> 2))
+        {
+            if (steps++ == RECORD_DRAIN_STEPS) return;
+            pongStep(start, inputs);
+            drained++;
+            continue;
+        }
+
+        if ((event >> 2) != RECORD_RUN_MAX)
+        {
+            start_inputs = event & 0x03;
+            inputs = bitInputs(start_inputs);
+        }
+        first = (first + 1) % RECORD_EVENTS;
+        count--;
+        drained = 0;
+    }
+}
+
+static void emit(uint8_t event)
+{
+    events[(first + count) % RECORD_EVENTS] = event;
+    count++;
+}
+
+// Close the run in progress, so the events cover every tick recorded so far
+static void flushRun()
+{
+    if (!held) return;
+    emit((held << 2) | current);
+    held = 0;
+}
+
+static void finishSave();
+
+void recordBegin(const PongState &state)
+{
+    finishSave();
+    start = state;
+    start_inputs = current = 0;
+    first = count = held = drained = 0;
+    recording = true;
+}
+
+void recordTick(const PongState &state, const PongInputs &inputs)
+{
+    if (!recording) return;
+
+    uint8_t bits = inputBits(inputs);
+
+    // Draining fell behind inputs that change every tick: start over from this tick, keeping
+    // a free slot for the run flushRun() closes
+    if (count >= RECORD_EVENTS - 1)
+    {
+        start = state;
+        start_inputs = current = bits;
+        first = count = held = drained = 0;
+    }
+
+    if (bits != current)
+    {
+        emit((held << 2) | bits);
+        current = bits;
+        held = 0;
+    }
+    if (++held == RECORD_RUN_MAX)
+    {
+        emit((RECORD_RUN_MAX << 2) | current);
+        held = 0;
+    }
+    drain();
+}
+
+// Image writer: every byte goes to 'out' with its offset in the image
+
+typedef void (*TraceOut)(uint16_t offset, uint8_t value);
+
+static uint16_t put8(TraceOut out, uint16_t offset, uint8_t value)
+{
+    out(offset, value);
+    return offset + 1;
+}
+
+static uint16_t put16(TraceOut out, uint16_t offset, uint16_t value)
+{
+    offset = put8(out, offset, value & 0xFF);
+    return put8(out, offset, value >> 8);
+}
+
+static uint16_t put32(TraceOut out, uint16_t offset, uint32_t value)
+{
+    offset = put16(out, offset, value & 0xFFFF);
+    return put16(out, offset, value >> 16);
+}
+
+static uint16_t putState(TraceOut out, uint16_t offset, const PongState &state)
+{
+    offset = put16(out, offset, state.ball_x);
+    offset = put16(out, offset, state.ball_y);
+    offset = put16(out, offset, state.ball_vx);
+    offset = put16(out, offset, state.ball_vy);
+    offset = put16(out, offset, state.ball_speed);
+    offset = put8(out, offset, state.cpu_y);
+    offset = put8(out, offset, state.player_y);
+    offset = put8(out, offset, state.ai.level);
+    offset = put8(out, offset, state.ai.reaction);
+    offset = put16(out, offset, state.ai.speed);
+    offset = put8(out, offset, state.ai.aim_error);
+    offset = put8(out, offset, state.ai.target_y);
+    offset = put8(out, offset, state.ai.wait);
+    offset = put16(out, offset, state.ai.travel);
+    offset = put8(out, offset, state.cpu_score);
+    offset = put8(out, offset, state.player_score);
+    offset = put32(out, offset, state.rng);
+    return put32(out, offset, state.tick);
+}
+
+// Returns the image length
+static uint16_t writeImage(TraceOut out, uint32_t tick, uint32_t rng)
+{
+    uint16_t offset = 0;
+    offset = put8(out, offset, RECORD_MAGIC_0);
+    offset = put8(out, offset, RECORD_MAGIC_1);
+    offset = put8(out, offset, RECORD_VERSION);
+    offset = putState(out, offset, start);
+    offset = put8(out, offset, start_inputs);
+    offset = put32(out, offset, tick);
+    offset = put32(out, offset, rng);
+    offset = put8(out, offset, count);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint8_t event = eventAt(i);
+        if (!i) event -= drained << 2;
+        offset = put8(out, offset, event);
+    }
+    return offset;
+}
+
+// Image reader (EEPROM)
+
+static uint8_t get8(uint16_t &offset)
+{
+    return EEPROM.read(RECORD_EEPROM_ADDRESS + offset++);
+}
+
+static uint16_t get16(uint16_t &offset)
+{
+    uint16_t low = get8(offset);
+    return low | ((uint16_t)get8(offset) << 8);
+}
+
+static uint32_t get32(uint16_t &offset)
+{
+    uint32_t low = get16(offset);
+    return low | ((uint32_t)get16(offset) << 16);
+}
+
+static void getState(uint16_t &offset, PongState &state)
+{
+    state.ball_x = get16(offset);
+    state.ball_y = get16(offset);
+    state.ball_vx = get16(offset);
+    state.ball_vy = get16(offset);
+    state.ball_speed = get16(offset);
+    state.cpu_y = get8(offset);
+    state.player_y = get8(offset);
+    state.ai.level = get8(offset);
+    state.ai.reaction = get8(offset);
+    state.ai.speed = get16(offset);
+    state.ai.aim_error = get8(offset);
+    state.ai.target_y = get8(offset);
+    state.ai.wait = get8(offset);
+    state.ai.travel = get16(offset);
+    state.cpu_score = get8(offset);
+    state.player_score = get8(offset);
+    state.rng = get32(offset);
+    state.tick = get32(offset);
+}
+
+// The saver picks one byte per pass out of a full writeImage() run: slower than a buffer,
+// but a copy of the image would take more RAM than the ring itself
+static uint16_t pick_offset;
+static uint8_t picked;
+
+static void pickOut(uint16_t offset, uint8_t value)
+{
+    if (offset == pick_offset) picked = value;
+}
+
+static bool eepromReady()
+{
+#if defined(__AVR__)
+    return eeprom_is_ready();
+#else
+    return nativeEEPROMReady();
+#endif
+}
+
+void recordSave(const PongState &state)
+{
+    if (!recording) return;
+    finishSave();
+    flushRun();
+
+    end_tick = state.tick;
+    end_rng = state.rng;
+    pick_offset = 0xFFFF;
+    save_length = writeImage(pickOut, end_tick, end_rng);
+    save_step = 0;
+    saving = true;
+}
+
+// Write the next byte of the save (EEPROM.update() waits for a write still in progress)
+static void saveNext()
+{
+    // Replays check the version byte, so until the header is rewritten last a save cut short
+    // by a reset reads as no trace rather than a mix of two
+    if (!save_step)
+    {
+        EEPROM.update(RECORD_EEPROM_ADDRESS + 2, (uint8_t)~RECORD_VERSION);
+    }
+    else
+    {
+        pick_offset = (save_step + 2) % save_length;
+        writeImage(pickOut, end_tick, end_rng);
+        EEPROM.update(RECORD_EEPROM_ADDRESS + pick_offset, picked);
+    }
+    saving = ++save_step <= save_length;
+}
+
+// Block until a save in progress is done (only when the next match or a replay comes
+// within the fraction of a second it takes)
+static void finishSave()
+{
+    while (saving) saveNext();
+}
+
+bool recordService()
+{
+    if (saving && eepromReady()) saveNext();
+    return saving;
+}
+
+static void serialOut(uint16_t offset, uint8_t value)
+{
+    if (value < 0x10) Serial.print('0');
+    Serial.print(value, HEX);
+    if ((offset & 15) == 15) Serial.println();
+}
+
+void recordDump(const PongState &state)
+{
+    if (!recording) return;
+    flushRun();
+    writeImage(serialOut, state.tick, state.rng);
+    Serial.println();
+}
+
+bool replayBegin(PongState &state)
+{
+    finishSave();
+
+    uint16_t offset = 0;
+    if (get8(offset) != RECORD_MAGIC_0 || get8(offset) != RECORD_MAGIC_1 || get8(offset) != RECORD_VERSION)
+    {
+        return false;
+    }
+
+    // Checked before anything is replaced: a rejected image leaves the match being recorded
+    // as it was
+    PongState loaded;
+    getState(offset, loaded);
+    uint8_t loaded_inputs = get8(offset);
+    uint32_t loaded_tick = get32(offset);
+    uint32_t loaded_rng = get32(offset);
+    uint8_t length = get8(offset);
+    if (length > RECORD_EVENTS) return false;
+
+    start = loaded;
+    start_inputs = loaded_inputs;
+    end_tick = loaded_tick;
+    end_rng = loaded_rng;
+    for (uint8_t i = 0; i < length; i++) events[i] = get8(offset);
+    first = drained = 0;
+    count = length;
+    recording = false;
+
+    replay_index = 0;
+    replay_left = 0;
+    replay_inputs = start_inputs;
+    replay_change = false;
+    state = start;
+    return true;
+}
+
+bool replayNext(PongInputs &inputs)
+{
+    while (!replay_left)
+    {
+        if (replay_change)
+        {
+            replay_inputs = replay_next;
+            replay_change = false;
+        }
+        if (replay_index == count) return false;
+
+        uint8_t event = eventAt(replay_index++);
+        replay_left = event >> 2;
+        if (replay_left != RECORD_RUN_MAX)
+        {
+            replay_next = event & 0x03;
+            replay_change = true;
+        }
+    }
+
+    replay_left--;
+    inputs = bitInputs(replay_inputs);
+    return true;
+}
+
+bool replayMatches(const PongState &state)
+{
+    return state.tick == end_tick && state.rng == end_rng;
+}
+
+#endif
@@ -0,0 +1,125 @@
+#include <pong_render.h>
+#include <pong_text.h>
+
+// Scoreboard line of the goal banner: "[CPU n : n PLAYER]"
+static void formatScoreboard(TextBuffer &line, uint8_t cpu_score, uint8_t player_score)
+{
+    line.append_P(PSTR("[CPU "));
+    line.appendUnsigned(cpu_score);
+    line.append_P(PSTR(" : "));
+    line.appendUnsigned(player_score);
+    line.append_P(PSTR(" PLAYER]"));
+}
+
+// The page renderer's display list points at the scoreboard text until the next screen
+static TextBuffer scoreboard;
+
+void drawCourt(PongDisplay &display, RallyView &view)
+{
+    display.clearDisplay();
+    display.addItem(sceneRect(0, 0, COURT_WIDTH, COURT_HEIGHT, WHITE));
+    view.valid = false;
+}
+
+#if PONG_PAGE_RENDER
+
+// Display list slots of the rally screen, in the order drawCourt() and drawRally() add them
+#define SLOT_CPU        1
+#define SLOT_PLAYER     2
+#define SLOT_BALL       3
+
+void drawRally(PongDisplay &display, RallyView &view, const PongState &state)
+{
+    if (view.valid)
+    {
+        display.moveItem(SLOT_CPU, CPU_X, state.cpu_y);
+        display.moveItem(SLOT_PLAYER, PLAYER_X, state.player_y);
+        display.moveItem(SLOT_BALL, ballPixelX(state), ballPixelY(state));
+    }
+    else
+    {
+        display.addItem(sceneFill(CPU_X, state.cpu_y, 1, PADDLE_LENGTH, WHITE));
+        display.addItem(sceneFill(PLAYER_X, state.player_y, 1, PADDLE_LENGTH, WHITE));
+        display.addItem(sceneFill(ballPixelX(state), ballPixelY(state), 1, 1, WHITE));
+    }
+
+    view.drawn = state;
+    view.valid = true;
+}
+
+#else
+
+// Whether a paddle at its current position covers pixel (x, y)
+static bool onPaddle(const PongState &state, uint8_t x, uint8_t y)
+{
+    if (x == CPU_X) return (uint8_t)(y - state.cpu_y) < PADDLE_LENGTH;
+    if (x == PLAYER_X) return (uint8_t)(y - state.player_y) < PADDLE_LENGTH;
+    return false;
+}
+
+void drawRally(PongDisplay &display, RallyView &view, const PongState &state)
+{
+    const PongState &drawn = view.drawn;
+
+    // Paddles: each page byte of the column is rewritten once, old paddle out and new one in
+    if (!view.valid || drawn.cpu_y != state.cpu_y)
+    {
+        display.moveColumn(CPU_X, view.valid ? drawn.cpu_y : state.cpu_y, state.cpu_y, PADDLE_LENGTH);
+    }
+    if (!view.valid || drawn.player_y != state.player_y)
+    {
+        display.moveColumn(PLAYER_X, view.valid ? drawn.player_y : state.player_y, state.player_y, PADDLE_LENGTH);
+    }
+
+    // Ball: the old pixel goes unless a paddle covers it now, and the new one is set even if
+    // the ball stayed (a paddle that moved off it cleared it)
+    uint8_t x = ballPixelX(state), y = ballPixelY(state);
+    uint8_t old_x = ballPixelX(drawn), old_y = ballPixelY(drawn);
+    if (view.valid && (old_x != x || old_y != y) && !onPaddle(state, old_x, old_y))
+    {
+        display.setPixelBit(old_x, old_y, false);
+    }
+    display.setPixelBit(x, y, true);
+
+    view.drawn = state;
+    view.valid = true;
+}
+
+#endif
+
+void drawMenu(PongDisplay &display)
+{
+    display.clearDisplay();
+    display.addItem(sceneRect(0, 0, COURT_WIDTH, COURT_HEIGHT, WHITE));
+
+    // Play button in a box, help text below
+    display.addItem(sceneUiText(UI_PLAY, WHITE));
+    display.addItem(sceneUiRect(UI_PLAY_BOX, false, WHITE));
+    display.addItem(sceneUiText(UI_PRESS_ANY_BUTTON, WHITE));
+}
+
+void drawMenuPress(PongDisplay &display)
+{
+    // Invert the play button colors
+    display.addItem(sceneUiRect(UI_PLAY_BOX, true, WHITE));
+    display.addItem(sceneUiText(UI_PLAY, BLACK));
+}
+
+void drawGoalBanner(PongDisplay &display, UiTextId headline, uint8_t cpu_score, uint8_t player_score)
+{
+    scoreboard = TextBuffer();
+    formatScoreboard(scoreboard, cpu_score, player_score);
+
+    // Clear the court area, then headline and scoreboard
+    display.addItem(sceneFill(1, 1, COURT_WIDTH - 2, COURT_HEIGHT - 2, BLACK));
+    display.addItem(sceneUiText(headline, WHITE));
+    display.addItem(sceneText(textCenterX(SCREEN_WIDTH, scoreboard.length, 1), UI_SCOREBOARD_Y,
+                              scoreboard.text, scoreboard.length, 1, WHITE));
+}
+
+void drawVictoryBanner(PongDisplay &display, UiTextId headline)
+{
+    display.clearDisplay();
+    display.addItem(sceneRect(0, 0, COURT_WIDTH, COURT_HEIGHT, WHITE));
+    display.addItem(sceneUiText(headline, WHITE));
+}
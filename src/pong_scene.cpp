@@ -0,0 +1,235 @@
+#include <pong_scene.h>
+
+// Classic 5x7 Adafruit GFX glyphs for printable ASCII, one byte per column (bit 0 on top).
+// Other characters render blank.
+#define FONT_FIRST      0x20
+#define FONT_LAST       0x7E
+#define FONT_COLUMNS    5
+
+static const uint8_t font[(FONT_LAST - FONT_FIRST + 1) * FONT_COLUMNS] PROGMEM =
+{
+    0x00, 0x00, 0x00, 0x00, 0x00,  // ' '
+    0x00, 0x00, 0x5F, 0x00, 0x00,  // '!'
+    0x00, 0x07, 0x00, 0x07, 0x00,  // '"'
+    0x14, 0x7F, 0x14, 0x7F, 0x14,  // '#'
+    0x24, 0x2A, 0x7F, 0x2A, 0x12,  // '$'
+    0x23, 0x13, 0x08, 0x64, 0x62,  // '%'
+    0x36, 0x49, 0x56, 0x20, 0x50,  // '&'
+    0x00, 0x08, 0x07, 0x03, 0x00,  // '\''
+    0x00, 0x1C, 0x22, 0x41, 0x00,  // '('
+    0x00, 0x41, 0x22, 0x1C, 0x00,  // ')'
+    0x2A, 0x1C, 0x7F, 0x1C, 0x2A,  // '*'
+    0x08, 0x08, 0x3E, 0x08, 0x08,  // '+'
+    0x00, 0x80, 0x70, 0x30, 0x00,  // ','
+    0x08, 0x08, 0x08, 0x08, 0x08,  // '-'
+    0x00, 0x00, 0x60, 0x60, 0x00,  // '.'
+    0x20, 0x10, 0x08, 0x04, 0x02,  // '/'
+    0x3E, 0x51, 0x49, 0x45, 0x3E,  // '0'
+    0x00, 0x42, 0x7F, 0x40, 0x00,  // '1'
+    0x72, 0x49, 0x49, 0x49, 0x46,  // '2'
+    0x21, 0x41, 0x49, 0x4D, 0x33,  // '3'
+    0x18, 0x14, 0x12, 0x7F, 0x10,  // '4'
+    0x27, 0x45, 0x45, 0x45, 0x39,  // '5'
+    0x3C, 0x4A, 0x49, 0x49, 0x31,  // '6'
+    0x41, 0x21, 0x11, 0x09, 0x07,  // '7'
+    0x36, 0x49, 0x49, 0x49, 0x36,  // '8'
+    0x46, 0x49, 0x49, 0x29, 0x1E,  // '9'
+    0x00, 0x00, 0x14, 0x00, 0x00,  // ':'
+    0x00, 0x40, 0x34, 0x00, 0x00,  // ';'
+    0x00, 0x08, 0x14, 0x22, 0x41,  // '<'
+    0x14, 0x14, 0x14, 0x14, 0x14,  // '='
+    0x00, 0x41, 0x22, 0x14, 0x08,  // '>'
+    0x02, 0x01, 0x59, 0x09, 0x06,  // '?'
+    0x3E, 0x41, 0x5D, 0x59, 0x4E,  // '@'
+    0x7C, 0x12, 0x11, 0x12, 0x7C,  // 'A'
+    0x7F, 0x49, 0x49, 0x49, 0x36,  // 'B'
+    0x3E, 0x41, 0x41, 0x41, 0x22,  // 'C'
+    0x7F, 0x41, 0x41, 0x41, 0x3E,  // 'D'
+    0x7F, 0x49, 0x49, 0x49, 0x41,  // 'E'
+    0x7F, 0x09, 0x09, 0x09, 0x01,  // 'F'
+    0x3E, 0x41, 0x41, 0x51, 0x73,  // 'G'
+    0x7F, 0x08, 0x08, 0x08, 0x7F,  // 'H'
+    0x00, 0x41, 0x7F, 0x41, 0x00,  // 'I'
+    0x20, 0x40, 0x41, 0x3F, 0x01,  // 'J'
+    0x7F, 0x08, 0x14, 0x22, 0x41,  // 'K'
+    0x7F, 0x40, 0x40, 0x40, 0x40,  // 'L'
+    0x7F, 0x02, 0x1C, 0x02, 0x7F,  // 'M'
+    0x7F, 0x04, 0x08, 0x10, 0x7F,  // 'N'
+    0x3E, 0x41, 0x41, 0x41, 0x3E,  // 'O'
+    0x7F, 0x09, 0x09, 0x09, 0x06,  // 'P'
+    0x3E, 0x41, 0x51, 0x21, 0x5E,  // 'Q'
+    0x7F, 0x09, 0x19, 0x29, 0x46,  // 'R'
+    0x26, 0x49, 0x49, 0x49, 0x32,  // 'S'
+    0x03, 0x01, 0x7F, 0x01, 0x03,  // 'T'
+    0x3F, 0x40, 0x40, 0x40, 0x3F,  // 'U'
+    0x1F, 0x20, 0x40, 0x20, 0x1F,  // 'V'
+    0x3F, 0x40, 0x38, 0x40, 0x3F,  // 'W'
+    0x63, 0x14, 0x08, 0x14, 0x63,  // 'X'
+    0x03, 0x04, 0x78, 0x04, 0x03,  // 'Y'
+    0x61, 0x59, 0x49, 0x4D, 0x43,  // 'Z'
+    0x00, 0x7F, 0x41, 0x41, 0x41,  // '['
+    0x02, 0x04, 0x08, 0x10, 0x20,  // backslash
+    0x00, 0x41, 0x41, 0x41, 0x7F,  // ']'
+    0x04, 0x02, 0x01, 0x02, 0x04,  // '^'
+    0x40, 0x40, 0x40, 0x40, 0x40,  // '_'
+    0x00, 0x03, 0x07, 0x08, 0x00,  // '`'
+    0x20, 0x54, 0x54, 0x78, 0x40,  // 'a'
+    0x7F, 0x28, 0x44, 0x44, 0x38,  // 'b'
+    0x38, 0x44, 0x44, 0x44, 0x28,  // 'c'
+    0x38, 0x44, 0x44, 0x28, 0x7F,  // 'd'
+    0x38, 0x54, 0x54, 0x54, 0x18,  // 'e'
+    0x00, 0x08, 0x7E, 0x09, 0x02,  // 'f'
+    0x18, 0xA4, 0xA4, 0x9C, 0x78,  // 'g'
+    0x7F, 0x08, 0x04, 0x04, 0x78,  // 'h'
+    0x00, 0x44, 0x7D, 0x40, 0x00,  // 'i'
+    0x20, 0x40, 0x40, 0x3D, 0x00,  // 'j'
+    0x7F, 0x10, 0x28, 0x44, 0x00,  // 'k'
+    0x00, 0x41, 0x7F, 0x40, 0x00,  // 'l'
+    0x7C, 0x04, 0x78, 0x04, 0x78,  // 'm'
+    0x7C, 0x08, 0x04, 0x04, 0x78,  // 'n'
+    0x38, 0x44, 0x44, 0x44, 0x38,  // 'o'
+    0xFC, 0x18, 0x24, 0x24, 0x18,  // 'p'
+    0x18, 0x24, 0x24, 0x18, 0xFC,  // 'q'
+    0x7C, 0x08, 0x04, 0x04, 0x08,  // 'r'
+    0x48, 0x54, 0x54, 0x54, 0x24,  // 's'
+    0x04, 0x04, 0x3F, 0x44, 0x24,  // 't'
+    0x3C, 0x40, 0x40, 0x20, 0x7C,  // 'u'
+    0x1C, 0x20, 0x40, 0x20, 0x1C,  // 'v'
+    0x3C, 0x40, 0x30, 0x40, 0x3C,  // 'w'
+    0x44, 0x28, 0x10, 0x28, 0x44,  // 'x'
+    0x4C, 0x90, 0x90, 0x90, 0x7C,  // 'y'
+    0x44, 0x64, 0x54, 0x4C, 0x44,  // 'z'
+    0x00, 0x08, 0x36, 0x41, 0x00,  // '{'
+    0x00, 0x00, 0x77, 0x00, 0x00,  // '|'
+    0x00, 0x41, 0x36, 0x08, 0x00,  // '}'
+    0x02, 0x01, 0x02, 0x04, 0x02,  // '~'
+};
+
+// Clamp a box size to what an item can hold
+static uint8_t boxSize(uint16_t size)
+{
+    return size > 255 ? 255 : size;
+}
+
+SceneItem sceneFill(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color)
+{
+    SceneItem item = { SCENE_FILL, color, x, y, w, h, 1, nullptr };
+    return item;
+}
+
+SceneItem sceneRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color)
+{
+    SceneItem item = { SCENE_RECT, color, x, y, w, h, 1, nullptr };
+    return item;
+}
+
+SceneItem sceneText(int16_t x, int16_t y, const char *text, uint8_t length, uint8_t size, uint8_t color)
+{
+    SceneItem item = { SCENE_TEXT, color, x, y, boxSize(textWidth(length, size)), boxSize(textHeight(size)), size, text };
+    return item;
+}
+
+SceneItem sceneUiText(UiTextId id, uint8_t color)
+{
+    UiText layout;
+    memcpy_P(&layout, &ui_text[id], sizeof(layout));
+    SceneItem item = { SCENE_TEXT_P, color, layout.x, layout.y, boxSize(layout.w), boxSize(layout.h), layout.size, layout.text };
+    return item;
+}
+
+SceneItem sceneUiRect(UiRectId id, bool filled, uint8_t color)
+{
+    UiRect rect;
+    memcpy_P(&rect, &ui_rect[id], sizeof(rect));
+    SceneItem item = { filled ? SCENE_FILL : SCENE_RECT, color, rect.x, rect.y, boxSize(rect.w), boxSize(rect.h), 1, nullptr };
+    return item;
+}
+
+// Rows first..last (0..7) of a page byte
+static inline uint8_t rowMask(uint8_t first, uint8_t last)
+{
+    return (0xFF << first) & (0xFF >> (7 - last));
+}
+
+static inline void paint(uint8_t &column, uint8_t mask, uint8_t color)
+{
+    switch (color)
+    {
+    case WHITE:     column |= mask; break;
+    case BLACK:     column &= ~mask; break;
+    case INVERSE:   column ^= mask; break;
+    }
+}
+
+// Glyph column 'column' of character 'c'
+static uint8_t glyphColumn(char c, uint8_t column)
+{
+    if ((uint8_t)c < FONT_FIRST || (uint8_t)c > FONT_LAST) return 0;
+    return pgm_read_byte(&font[((uint8_t)c - FONT_FIRST) * FONT_COLUMNS + column]);
+}
+
+// Text pixels of one column in rows top..bottom of the page starting at row 'page_top'
+static uint8_t textMask(const SceneItem &item, int16_t x, int16_t page_top, int16_t top, int16_t bottom)
+{
+    // Character cell and the glyph column inside it (the sixth one is spacing)
+    uint8_t offset = x - item.x;
+    uint8_t cell = FONT_CHAR_WIDTH * item.size;
+    uint8_t column = (offset % cell) / item.size;
+    if (column >= FONT_COLUMNS) return 0;
+
+    const char *c = item.text + offset / cell;
+    uint8_t line = glyphColumn(item.kind == SCENE_TEXT_P ? (char)pgm_read_byte(c) : *c, column);
+    if (!line) return 0;
+
+    // Size 1: the glyph column is the page byte, shifted to the text row
+    if (item.size == 1)
+    {
+        int16_t shift = item.y - page_top;
+        uint8_t shifted = shift >= 0 ? line << shift : line >> -shift;
+        return shifted & rowMask(top - page_top, bottom - page_top);
+    }
+
+    uint8_t mask = 0;
+    for (int16_t y = top; y <= bottom; y++)
+    {
+        if (line & (1 << ((y - item.y) / item.size))) mask |= 1 << (y - page_top);
+    }
+    return mask;
+}
+
+void scenePaint(const SceneItem &item, uint8_t page, uint8_t col_start, uint8_t col_end, uint8_t *out)
+{
+    const int16_t page_top = (int16_t)page * 8;
+    int16_t right = item.x + item.w - 1, bottom = item.y + item.h - 1;
+
+    // Part of the item inside this span
+    int16_t x0 = item.x > col_start ? item.x : col_start;
+    int16_t x1 = right < col_end ? right : col_end;
+    int16_t y0 = item.y > page_top ? item.y : page_top;
+    int16_t y1 = bottom < page_top + 7 ? bottom : page_top + 7;
+    if (x0 > x1 || y0 > y1) return;
+
+    uint8_t rows = rowMask(y0 - page_top, y1 - page_top);
+    uint8_t edges = 0;      // Rect: top and bottom rows in this page
+    if (item.y >= y0 && item.y <= y1) edges |= 1 << (item.y - page_top);
+    if (bottom >= y0 && bottom <= y1) edges |= 1 << (bottom - page_top);
+
+    for (int16_t x = x0; x <= x1; x++)
+    {
+        uint8_t mask;
+        switch (item.kind)
+        {
+        case SCENE_FILL:    mask = rows; break;
+        case SCENE_RECT:    mask = x == item.x || x == right ? rows : edges; break;
+        default:            mask = textMask(item, x, page_top, y0, y1); break;
+        }
+        paint(out[x - col_start], mask, item.color);
+    }
+}
+
+void sceneRender(const SceneItem *items, uint8_t count, uint8_t page, uint8_t col_start, uint8_t col_end,
+                 uint8_t *out)
+{
+    memset(out, 0, col_end - col_start + 1);
+    for (uint8_t i = 0; i < count; i++) scenePaint(items[i], page, col_start, col_end, out);
+}
@@ -0,0 +1,192 @@
+#include <pong_sched.h>
+#include <pong_input.h>
+#include <pong_telemetry.h>
+#include <pong_twi.h>
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#else
+#include <native_hal.h>
+#endif
+
+// Timer1 compare value: SCHED_TICK_US of clk/8
+#define SCHED_TIMER_TOP ((F_CPU / 1000000UL) * SCHED_TICK_US / 8 - 1)
+
+#if defined(__AVR__) && SCHED_TIMER_TOP > 0xFFFF
+#error "SCHED_TICK_US is too long for Timer1 at clk/8"
+#endif
+
+struct SchedTask
+{
+    SchedTime period;
+    SchedTime due;      // Next deadline
+    bool running;
+};
+
+static SchedTask tasks[SCHED_TASKS];
+
+#if defined(__AVR__)
+static volatile SchedTime ticks = 0;
+
+ISR(TIMER1_COMPA_vect)
+{
+    ticks++;
+}
+#endif
+
+void schedBegin()
+{
+#if defined(__AVR__)
+    noInterrupts();
+    TCCR1A = 0;
+    TCCR1B = _BV(WGM12) | _BV(CS11);    // CTC on OCR1A, clk/8
+    TCNT1 = 0;
+    OCR1A = SCHED_TIMER_TOP;
+    TIFR1 = _BV(OCF1A);
+    TIMSK1 = _BV(OCIE1A);
+    interrupts();
+#endif
+}
+
+SchedTime schedNow()
+{
+#if defined(__AVR__)
+    // Two bytes the interrupt writes
+    uint8_t sreg = SREG;
+    cli();
+    SchedTime now = ticks;
+    SREG = sreg;
+    return now;
+#else
+    // The virtual clock; reading it costs time like micros() does, so polling loops advance
+    return (SchedTime)(micros() / SCHED_TICK_US);
+#endif
+}
+
+void schedStart(SchedTaskId task, SchedTime period, SchedTime first)
+{
+    tasks[task].period = period;
+    tasks[task].due = first;
+    tasks[task].running = true;
+}
+
+void schedStop(SchedTaskId task)
+{
+    tasks[task].running = false;
+}
+
+uint8_t schedDue(SchedTaskId task, SchedTime now, uint8_t limit)
+{
+    SchedTask &t = tasks[task];
+    if (!t.running || !schedReached(now, t.due)) return 0;
+
+    SchedTime late = schedSince(now, t.due);
+    uint8_t due = 0;
+    while (schedReached(now, t.due) && due < limit)
+    {
+        t.due += t.period;
+        due++;
+    }
+
+    // Too far behind: drop the rest instead of bursting later
+    uint16_t missed = 0;
+    if (schedReached(now, t.due))
+    {
+        missed = schedSince(now, t.due) / t.period + 1;
+        t.due = now + t.period;
+    }
+
+    telemetryTask(task, late, missed);
+    return due;
+}
+
+// Whether any running task has a deadline at or before 'now'
+static bool anyDue(SchedTime now)
+{
+    for (uint8_t i = 0; i < SCHED_TASKS; i++)
+    {
+        if (tasks[i].running && schedReached(now, tasks[i].due)) return true;
+    }
+    return false;
+}
+
+#if defined(__AVR__)
+// Timer1 counts (clk/8) from tick 'since_ticks', count 'since_count' to now. Interrupts must
+// be disabled; a compare match whose interrupt is still pending counts as its tick.
+static uint32_t timerCountsSince(SchedTime since_ticks, uint16_t since_count)
+{
+    uint16_t count = TCNT1;
+    SchedTime now = ticks;
+    if ((TIFR1 & _BV(OCF1A)) && count < SCHED_TIMER_TOP / 2) now++;
+    return (uint32_t)(SchedTime)(now - since_ticks) * (SCHED_TIMER_TOP + 1) + count - since_count;
+}
+#endif
+
+void schedIdle()
+{
+    if (twiWaiting() || anyDue(schedNow())) return;
+
+#if defined(__AVR__)
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    cli();
+    SchedTime start_ticks = ticks;
+    uint16_t start_count = TCNT1;
+
+    // Other interrupts (panel transfer bytes, buttons, Serial) do their work in their
+    // handlers and the tasks only look at it on a tick, so sleep on until the next one
+    do
+    {
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+        cli();
+    }
+    while (ticks == start_ticks);
+    uint32_t slept = timerCountsSince(start_ticks, start_count);
+    sei();
+    telemetrySleep(slept * 8 / (F_CPU / 1000000UL));
+#else
+    // Until the next scheduler tick (the input script and a panel transfer still run, like
+    // the pin change and TWI interrupts)
+    uint64_t start = nativeMicros();
+    nativeAdvanceMicros(SCHED_TICK_US - start % SCHED_TICK_US);
+    telemetrySleep(nativeMicros() - start);
+#endif
+}
+
+void schedPowerDown()
+{
+    if (twiBusy()) return;
+    unsigned long start = millis();
+
+#if defined(__AVR__)
+    // The ADC would keep drawing current
+    uint8_t adcsra = ADCSRA;
+    ADCSRA = 0;
+
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    cli();
+    bool idle = inputIdle();
+    if (idle)
+    {
+        sleep_enable();
+        sleep_bod_disable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+    }
+    sei();
+    ADCSRA = adcsra;
+#else
+    bool idle = inputIdle();
+    while (inputIdle()) nativeAdvanceMicros(SCHED_TICK_US);
+#endif
+    if (!idle) return;
+
+    // Deadlines passed while the clocks were stopped (or on the host, ran on) are not missed
+    SchedTime now = schedNow();
+    for (uint8_t i = 0; i < SCHED_TASKS; i++) tasks[i].due = now;
+    telemetryPowerDown(millis() - start);
+}
@@ -0,0 +1,234 @@
+#include <pong_sim.h>
+
+uint32_t pongRandom(PongState &state)
+{
+    // xorshift32: cheap on AVR and never returns to zero from a non-zero seed
+    uint32_t x = state.rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return state.rng = x;
+}
+
+void pongReset(PongState &state, uint32_t seed)
+{
+    state.rng = seed ? seed : 1;
+    state.cpu_score = state.player_score = 0;
+    state.tick = 0;
+
+    // First serve of a match is always the same: towards the player at the default difficulty
+    state.ball_x = toFixed(COURT_WIDTH / 2), state.ball_y = toFixed(COURT_HEIGHT / 2);
+    state.ball_speed = BALL_SERVE_SPEED;
+    state.ball_vx = state.ball_vy = BALL_SERVE_SPEED;
+    state.cpu_y = state.player_y = PADDLE_START_Y;
+    aiSetLevel(state.ai, 18);
+    aiPlan(state);
+}
+
+void pongServe(PongState &state)
+{
+    state.ball_x = toFixed(COURT_WIDTH / 2), state.ball_y = toFixed(COURT_HEIGHT / 2);
+
+    // Random diagonal direction for the reset ball, back at serve speed
+    state.ball_speed = BALL_SERVE_SPEED;
+    state.ball_vx = (pongRandom(state) & 1) ? BALL_SERVE_SPEED : -BALL_SERVE_SPEED;
+    state.ball_vy = (pongRandom(state) & 1) ? BALL_SERVE_SPEED : -BALL_SERVE_SPEED;
+
+    // Reset paddles
+    state.player_y = state.cpu_y = PADDLE_START_Y;
+
+    // Randomize CPU difficulty
+    aiSetLevel(state.ai, pongRandom(state) % (AI_MAX_LEVEL + 1));
+    aiPlan(state);
+}
+
+// Send the ball back off a paddle: faster, and at an angle set by where it hit the paddle
+static void deflect(PongState &state, int16_t ball_y, uint8_t paddle_y, int8_t dir_x)
+{
+    int8_t offset = toPixel(ball_y) - (paddle_y + half_paddle);
+    if (offset < -(int8_t)half_paddle) offset = -half_paddle;
+    if (offset > (int8_t)half_paddle) offset = half_paddle;
+
+    if (state.ball_speed < BALL_MAX_SPEED) state.ball_speed += BALL_SPEEDUP;
+    state.ball_vx = dir_x > 0 ? state.ball_speed : -state.ball_speed;
+    state.ball_vy = ((int32_t)state.ball_speed * (offset * DEFLECTION_STEP)) >> FIXED_SHIFT;
+}
+
+// Distance covered at velocity 'v' in 'time' (tick fraction)
+static int16_t travel(int16_t v, uint16_t time)
+{
+    if (time == TICK_FRACTION) return v;
+    return ((int32_t)v * time) >> FIXED_SHIFT;
+}
+
+// Ball coordinate (8.8) pinned to the int16 range. Only a multi-tick sweep that leaves the
+// court gets that far, and it stays past the goal line it crossed.
+static int16_t narrowFixed(int32_t fixed)
+{
+    if (fixed < -32768) return -32768;
+    if (fixed > 32767) return 32767;
+    return fixed;
+}
+
+// Time for velocity 'v' to cover 'distance' (same sign), clamped to 'limit'
+static uint16_t timeToCover(int16_t distance, int16_t v, uint16_t limit)
+{
+    uint32_t time = ((int32_t)distance << FIXED_SHIFT) / v;
+    return time < limit ? time : limit;
+}
+
+// Paddle span the ball can hit, top pixel to bottom pixel inclusive
+static bool onPaddle(int16_t ball_y, uint8_t paddle_y)
+{
+    uint8_t pixel_y = toPixel(ball_y);
+    return pixel_y >= paddle_y && pixel_y <= paddle_y + PADDLE_LENGTH;
+}
+
+uint8_t pongSweepBall(PongState &state, uint16_t duration, PongContact *contacts)
+{
+    uint8_t count = 0;
+    uint16_t elapsed = 0;
+    // Paddle faces are only solid from the front: once the ball is behind one (or slipped
+    // past its end this sweep) it can no longer bounce off it
+    bool cpu_open = state.ball_x >= CPU_PADDLE_FACE;
+    bool player_open = state.ball_x <= PLAYER_PADDLE_FACE;
+
+    while (elapsed < duration)
+    {
+        uint16_t remaining = duration - elapsed;
+        // In 32 bits: 16 ticks at top speed from the edge of the court overflow 8.8 int16
+        int32_t end_x = (int32_t)state.ball_x + travel(state.ball_vx, remaining);
+        int32_t end_y = (int32_t)state.ball_y + travel(state.ball_vy, remaining);
+
+        // Earliest surface the straight path to the end point crosses. The common case of no
+        // crossing costs four compares; the divisions only run on an actual bounce.
+        uint16_t hit_time = remaining;
+        uint8_t hit = 0xFF;
+        if (end_y < BALL_MIN_Y)
+        {
+            hit_time = timeToCover(BALL_MIN_Y - state.ball_y, state.ball_vy, hit_time);
+            hit = SURFACE_TOP_WALL;
+        }
+        else if (end_y > BALL_MAX_Y)
+        {
+            hit_time = timeToCover(BALL_MAX_Y - state.ball_y, state.ball_vy, hit_time);
+            hit = SURFACE_BOTTOM_WALL;
+        }
+        if (cpu_open && end_x < CPU_PADDLE_FACE)
+        {
+            uint16_t time = timeToCover(CPU_PADDLE_FACE - state.ball_x, state.ball_vx, remaining);
+            if (hit == 0xFF || time < hit_time) hit_time = time, hit = SURFACE_CPU_PADDLE;
+        }
+        else if (player_open && end_x > PLAYER_PADDLE_FACE)
+        {
+            uint16_t time = timeToCover(PLAYER_PADDLE_FACE - state.ball_x, state.ball_vx, remaining);
+            if (hit == 0xFF || time < hit_time) hit_time = time, hit = SURFACE_PLAYER_PADDLE;
+        }
+
+        // Free flight to the end, or out of bounce budget: finish the move inside the court
+        if (hit == 0xFF || count == MAX_CONTACTS)
+        {
+            state.ball_x = narrowFixed(end_x);
+            if (end_y < BALL_MIN_Y) end_y = BALL_MIN_Y;
+            if (end_y > BALL_MAX_Y) end_y = BALL_MAX_Y;
+            state.ball_y = end_y;
+            break;
+        }
+
+        // Advance to the point of impact, landing exactly on the surface
+        state.ball_x += travel(state.ball_vx, hit_time);
+        state.ball_y += travel(state.ball_vy, hit_time);
+
+        bool bounced = true;
+        switch (hit)
+        {
+        case SURFACE_TOP_WALL:
+            state.ball_y = BALL_MIN_Y;
+            state.ball_vy = -state.ball_vy;
+            break;
+        case SURFACE_BOTTOM_WALL:
+            state.ball_y = BALL_MAX_Y;
+            state.ball_vy = -state.ball_vy;
+            break;
+        case SURFACE_CPU_PADDLE:
+            state.ball_x = CPU_PADDLE_FACE;
+            cpu_open = false;
+            bounced = onPaddle(state.ball_y, state.cpu_y);
+            if (bounced) deflect(state, state.ball_y, state.cpu_y, 1);
+            break;
+        case SURFACE_PLAYER_PADDLE:
+            state.ball_x = PLAYER_PADDLE_FACE;
+            player_open = false;
+            bounced = onPaddle(state.ball_y, state.player_y);
+            if (bounced) deflect(state, state.ball_y, state.player_y, -1);
+            break;
+        }
+        elapsed += hit_time;
+
+        // A miss is not a bounce: the ball carries on past the paddle face
+        if (!bounced) continue;
+        if (contacts)
+        {
+            contacts[count].surface = (PongSurface)hit;
+            contacts[count].time = elapsed;
+        }
+        count++;
+    }
+    return count;
+}
+
+// Move ball to its next location, bouncing off walls and paddles, and call goals
+static PongEvent stepBall(PongState &state)
+{
+    PongContact contacts[MAX_CONTACTS];
+    uint8_t count = pongSweepBall(state, TICK_FRACTION, contacts);
+
+    // The CPU only needs to think again when a paddle sent the ball on a new course
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (contacts[i].surface == SURFACE_CPU_PADDLE || contacts[i].surface == SURFACE_PLAYER_PADDLE)
+        {
+            aiPlan(state);
+            break;
+        }
+    }
+
+    // Past a paddle and over the line: goal
+    if (state.ball_x < BALL_MIN_X)
+    {
+        state.player_score += 1;
+        pongServe(state);
+        return EVENT_PLAYER_GOAL;
+    }
+    if (state.ball_x > BALL_MAX_X)
+    {
+        state.cpu_score += 1;
+        pongServe(state);
+        return EVENT_CPU_GOAL;
+    }
+    return EVENT_NONE;
+}
+
+// Move both paddles: the CPU heads for its planned target, the player follows the controls
+static void stepPaddles(PongState &state, const PongInputs &inputs)
+{
+    // The CPU target is always inside the court, so it needs no boundary check
+    aiStep(state);
+
+    if (inputs.up) state.player_y -= 1;
+    if (inputs.down) state.player_y += 1;
+    // Boundary implementation
+    if (state.player_y < 1) state.player_y = 1;
+    if (state.player_y + PADDLE_LENGTH > COURT_HEIGHT - 1) state.player_y = COURT_HEIGHT - 1 - PADDLE_LENGTH;
+}
+
+PongEvent pongStep(PongState &state, const PongInputs &inputs)
+{
+    state.tick++;
+
+    PongEvent event = stepBall(state);
+    if (event != EVENT_NONE) return event;
+
+    stepPaddles(state, inputs);
+    return EVENT_NONE;
+}
@@ -0,0 +1,133 @@
+#include <pong_telemetry.h>
+
+#if PONG_TELEMETRY
+
+Telemetry telemetry;
+
+void telemetryBegin()
+{
+    telemetryReset();
+}
+
+void telemetryReset()
+{
+    memset(&telemetry, 0, sizeof(telemetry));
+    telemetry.since_ms = millis();
+}
+
+void telemetryFlush(uint16_t duration_us)
+{
+    uint8_t bucket = 0;
+    uint16_t limit = duration_us >> TELEMETRY_FLUSH_SHIFT;
+    while (limit && bucket < TELEMETRY_FLUSH_BUCKETS - 1)
+    {
+        limit >>= 1;
+        bucket++;
+    }
+    if (telemetry.flush_histogram[bucket] != 0xFFFF) telemetry.flush_histogram[bucket]++;
+
+    telemetry.flush_us += duration_us;
+    if (duration_us > telemetry.max_flush_us) telemetry.max_flush_us = duration_us;
+}
+
+void telemetryFrame(unsigned long time)
+{
+    telemetry.frames++;
+    if (telemetry.frame_ticks > telemetry.max_frame_ticks) telemetry.max_frame_ticks = telemetry.frame_ticks;
+    telemetry.frame_ticks = 0;
+
+    if (!telemetry.input_pending) return;
+    uint16_t latency = time - telemetry.input_time;
+    telemetry.inputs++;
+    telemetry.input_latency_ms += latency;
+    if (latency > telemetry.max_input_latency_ms) telemetry.max_input_latency_ms = latency;
+    telemetry.input_pending = false;
+}
+
+static void printAverage(uint32_t total, uint32_t count)
+{
+    Serial.print(count ? total / count : 0);
+}
+
+// Task names for the dump, in SchedTaskId order
+static const char task_names[SCHED_TASKS][8] PROGMEM = { "input", "physics", "render", "serial", "record" };
+
+static void dump()
+{
+    for (uint8_t i = 0; i < SCHED_TASKS; i++)
+    {
+        const TelemetryTask &record = telemetry.tasks[i];
+        Serial.print(F("task "));
+        Serial.print(reinterpret_cast<const __FlashStringHelper *>(task_names[i]));
+        Serial.print(F(" runs "));
+        Serial.print(record.runs);
+        Serial.print(F(" late us avg "));
+        printAverage(record.late * SCHED_TICK_US, record.runs);
+        Serial.print(F(" max "));
+        Serial.print((uint32_t)record.max_late * SCHED_TICK_US);
+        Serial.print(F(" missed "));
+        Serial.println(record.missed);
+    }
+
+    Serial.print(F("ticks "));
+    Serial.println(telemetry.ticks);
+
+    Serial.print(F("frames "));
+    Serial.print(telemetry.frames);
+    Serial.print(F(" ticks/frame avg "));
+    printAverage(telemetry.ticks, telemetry.frames);
+    Serial.print(F(" max "));
+    Serial.println(telemetry.max_frame_ticks);
+
+    Serial.print(F("flush us avg "));
+    uint32_t flushes = 0;
+    for (uint8_t i = 0; i < TELEMETRY_FLUSH_BUCKETS; i++) flushes += telemetry.flush_histogram[i];
+    printAverage(telemetry.flush_us, flushes);
+    Serial.print(F(" max "));
+    Serial.println(telemetry.max_flush_us);
+    for (uint8_t i = 0; i < TELEMETRY_FLUSH_BUCKETS; i++)
+    {
+        Serial.print(i < TELEMETRY_FLUSH_BUCKETS - 1 ? F("  < ") : F("  >= "));
+        Serial.print(1UL << (TELEMETRY_FLUSH_SHIFT + (i < TELEMETRY_FLUSH_BUCKETS - 1 ? i : i - 1)));
+        Serial.print(F(" us: "));
+        Serial.println(telemetry.flush_histogram[i]);
+    }
+
+    Serial.print(F("bus bytes "));
+    Serial.println(telemetry.bus_bytes);
+
+    Serial.print(F("input latency ms avg "));
+    printAverage(telemetry.input_latency_ms, telemetry.inputs);
+    Serial.print(F(" max "));
+    Serial.print(telemetry.max_input_latency_ms);
+    Serial.print(F(" presses "));
+    Serial.println(telemetry.inputs);
+
+    // Awake share of the time the clocks ran
+    uint32_t run_ms = millis() - telemetry.since_ms - telemetry.power_down_ms;
+    uint32_t awake_ms = run_ms - telemetry.sleep_ms;
+    Serial.print(F("awake ms "));
+    Serial.print(awake_ms);
+    Serial.print(F(" of "));
+    Serial.print(run_ms);
+    // awake_ms * 1000 overflows 32 bits after 71 minutes awake
+    uint32_t permille = run_ms ? (uint32_t)((uint64_t)awake_ms * 1000 / run_ms) : 0;
+    Serial.print(F(" ("));
+    Serial.print(permille / 10);
+    Serial.print('.');
+    Serial.print(permille % 10);
+    Serial.print(F("%) power downs "));
+    Serial.println(telemetry.power_downs);
+}
+
+bool telemetryCommand(char command)
+{
+    switch (command)
+    {
+    case 't': dump(); return true;
+    case 'r': telemetryReset(); return true;
+    default: return false;
+    }
+}
+
+#endif
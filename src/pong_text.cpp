@@ -0,0 +1,37 @@
+#include <pong_text.h>
+
+uint8_t formatUnsigned(char *out, uint16_t value)
+{
+    // Digits come out least significant first, so fill a scratch buffer backwards
+    char digits[5];
+    uint8_t count = 0;
+    do
+    {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+
+    for (uint8_t i = 0; i < count; i++) out[i] = digits[count - 1 - i];
+    out[count] = '\0';
+    return count;
+}
+
+void TextBuffer::append(char c)
+{
+    if (length >= TEXT_BUFFER_SIZE - 1) return;
+    text[length++] = c;
+    text[length] = '\0';
+}
+
+void TextBuffer::append_P(const char *str)
+{
+    char c;
+    while ((c = pgm_read_byte(str++))) append(c);
+}
+
+void TextBuffer::appendUnsigned(uint16_t value)
+{
+    char digits[6];
+    formatUnsigned(digits, value);
+    for (char *c = digits; *c; c++) append(*c);
+}
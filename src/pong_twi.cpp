@@ -0,0 +1,300 @@
+#include <pong_twi.h>
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#include <util/twi.h>
+#else
+#include <native_hal.h>
+#endif
+
+#if defined(__AVR__) && (F_CPU / PONG_TWI_CLOCK) < 16
+#error "PONG_TWI_CLOCK is too fast for F_CPU (TWBR would be negative)"
+#endif
+
+#if 256 % TWI_QUEUE_SIZE
+#error "TWI_QUEUE_SIZE must divide 256 (the ring indices wrap there)"
+#endif
+
+// TWIE goes with every TWCR write when the interrupt runs the transmitter
+#if defined(__AVR__) && TWI_INTERRUPT
+#define TWCR_INTERRUPT  _BV(TWIE)
+#else
+#define TWCR_INTERRUPT  0
+#endif
+
+// Where the current transaction is
+enum TwiPhase : uint8_t
+{
+    TWI_IDLE,
+    TWI_START,      // START sent
+    TWI_ADDRESS,    // Address byte sent
+    TWI_DATA,       // Control or data byte sent
+    TWI_STOP        // STOP sent
+};
+
+// Transaction ring: twiQueue() only writes 'queue_head', the transmitter only 'queue_tail'.
+// Both count up through 256, so their difference is the number queued, and like the input
+// queue neither side needs to disable interrupts for the other.
+static TwiTransaction queue[TWI_QUEUE_SIZE];
+static volatile uint8_t queue_head = 0, queue_tail = 0;
+
+static uint8_t device_address;
+static volatile TwiPhase phase = TWI_IDLE;
+static uint8_t sent;                // Data bytes of the current transaction sent
+static volatile uint16_t errors = 0;
+
+#if defined(__AVR__)
+static uint8_t saved_twbr;          // Wire's clock setting, restored once the queue drains
+#endif
+
+// Hardware access: TWI registers on AVR, the native HAL's TWI model on the host
+
+static void hwBegin()
+{
+#if defined(__AVR__)
+    saved_twbr = TWBR;
+    TWSR &= ~(_BV(TWPS0) | _BV(TWPS1));
+    TWBR = ((F_CPU / PONG_TWI_CLOCK) - 16) / 2;
+#else
+    nativeTwiSetClock(PONG_TWI_CLOCK);
+#endif
+}
+
+static void hwEnd()
+{
+#if defined(__AVR__)
+    TWBR = saved_twbr;
+#endif
+}
+
+static void hwStart()
+{
+#if defined(__AVR__)
+    TWCR = _BV(TWINT) | _BV(TWSTA) | _BV(TWEN) | TWCR_INTERRUPT;
+#else
+    nativeTwiStart();
+#endif
+}
+
+static void hwWrite(uint8_t data)
+{
+#if defined(__AVR__)
+    TWDR = data;
+    TWCR = _BV(TWINT) | _BV(TWEN) | TWCR_INTERRUPT;
+#else
+    nativeTwiWrite(data);
+#endif
+}
+
+static void hwStop()
+{
+#if defined(__AVR__)
+    TWCR = _BV(TWINT) | _BV(TWSTO) | _BV(TWEN) | TWCR_INTERRUPT;
+#else
+    nativeTwiStop();
+#endif
+}
+
+// The last START/byte finished (TWINT), or for a STOP, the bus is free again
+static bool hwReady()
+{
+#if defined(__AVR__)
+    if (phase == TWI_STOP) return !(TWCR & _BV(TWSTO));
+    return TWCR & _BV(TWINT);
+#else
+    return nativeTwiReady();
+#endif
+}
+
+// Status after the last operation was what the current phase expects
+static bool hwAcknowledged()
+{
+#if defined(__AVR__)
+    uint8_t status = TW_STATUS;
+    switch (phase)
+    {
+    case TWI_START:     return status == TW_START || status == TW_REP_START;
+    case TWI_ADDRESS:   return status == TW_MT_SLA_ACK;
+    case TWI_DATA:      return status == TW_MT_DATA_ACK;
+    default:            return true;
+    }
+#else
+    return true;
+#endif
+}
+
+// Let a transfer run while waiting on it: the emulated interrupt only runs as the virtual
+// clock moves (polling moves it by reading micros())
+static void hwWait()
+{
+#if TWI_INTERRUPT && !defined(__AVR__)
+    nativeAdvanceMicros(NATIVE_CALL_COST_US);
+#endif
+}
+
+static uint8_t queued()
+{
+    return queue_head - queue_tail;
+}
+
+void twiBegin(uint8_t address)
+{
+    device_address = address;
+}
+
+bool twiQueue(uint8_t control, const uint8_t *data, uint8_t length, uint8_t flags)
+{
+    uint8_t head = queue_head;
+    if ((uint8_t)(head - queue_tail) == TWI_QUEUE_SIZE) return false;
+
+    TwiTransaction &transaction = queue[head % TWI_QUEUE_SIZE];
+    transaction.data = data;
+    transaction.length = length;
+    transaction.control = control;
+    transaction.flags = flags;
+    queue_head = head + 1;
+    return true;
+}
+
+uint8_t twiQueueSpace()
+{
+    return TWI_QUEUE_SIZE - queued();
+}
+
+bool twiBusy()
+{
+    return queued() || phase != TWI_IDLE;
+}
+
+bool twiWaiting()
+{
+#if TWI_INTERRUPT
+    return phase == TWI_IDLE && queued();
+#else
+    return twiBusy();
+#endif
+}
+
+// Do one step if the hardware is ready for it, returns false when there is nothing to do yet
+static bool twiStep()
+{
+    if (phase == TWI_IDLE)
+    {
+        if (!queued()) return false;
+        // Phase first: the START's interrupt can come before the next line would
+        phase = TWI_START;
+        hwStart();
+        return true;
+    }
+
+    if (!hwReady()) return false;
+    if (!hwAcknowledged())
+    {
+        // Nobody listening: give up on everything queued, the caller resends on its next flush
+        hwStop();
+        errors++;
+        queue_tail = queue_head;
+        phase = TWI_STOP;
+        return true;
+    }
+
+    const TwiTransaction &transaction = queue[queue_tail % TWI_QUEUE_SIZE];
+    switch (phase)
+    {
+    case TWI_START:
+        hwWrite(device_address << 1);
+        phase = TWI_ADDRESS;
+        break;
+    case TWI_ADDRESS:
+        hwWrite(transaction.control);
+        sent = 0;
+        phase = TWI_DATA;
+        break;
+    case TWI_DATA:
+        if (sent < transaction.length)
+        {
+            const uint8_t *data = transaction.data + (transaction.flags & TWI_REPEAT ? 0 : sent);
+            hwWrite(transaction.flags & TWI_PROGMEM ? pgm_read_byte(data) : *data);
+            sent++;
+            break;
+        }
+        hwStop();
+        phase = TWI_STOP;
+        queue_tail++;
+        break;
+    case TWI_STOP:
+        phase = TWI_IDLE;
+        if (!queued())
+        {
+            hwEnd();
+            return false;
+        }
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+#if TWI_INTERRUPT
+// The transmitter, run at the end of every START and byte. A STOP raises no interrupt: it is
+// waited out here (a few bus clocks) and the next queued transaction started right away.
+static void twiInterrupt()
+{
+    while (twiStep() || phase == TWI_STOP);
+}
+
+#if defined(__AVR__)
+ISR(TWI_vect)
+{
+    twiInterrupt();
+}
+#endif
+#endif
+
+void twiInit()
+{
+#if defined(__AVR__)
+    // Internal pull-ups on SDA and SCL, then the transmitter's clock (TWIE comes with the
+    // first START)
+    digitalWrite(SDA, HIGH);
+    digitalWrite(SCL, HIGH);
+    TWSR &= ~(_BV(TWPS0) | _BV(TWPS1));
+    TWBR = ((F_CPU / PONG_TWI_CLOCK) - 16) / 2;
+    TWCR = _BV(TWEN);
+#elif TWI_INTERRUPT
+    nativeAttachTwiInterrupt(twiInterrupt);
+#endif
+}
+
+void twiService()
+{
+#if TWI_INTERRUPT
+    // Only an idle transmitter has no interrupt coming to move it on
+    if (phase != TWI_IDLE || !queued()) return;
+    hwBegin();
+    twiStep();
+#else
+    bool starting = phase == TWI_IDLE && queued();
+    if (starting) hwBegin();
+    while (twiStep());
+#endif
+}
+
+void twiFinish()
+{
+    while (twiBusy())
+    {
+        twiService();
+        hwWait();
+    }
+}
+
+uint16_t twiErrors()
+{
+    // Two bytes the interrupt writes
+    noInterrupts();
+    uint16_t count = errors;
+    interrupts();
+    return count;
+}
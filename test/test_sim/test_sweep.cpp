@@ -0,0 +1,68 @@
+// Swept ball movement (pongSweepBall) over more than one tick. Run with:
+//   pio test -e test_native
+#include <unity.h>
+#include <pong_sim.h>
+
+// Ball at pixel (x, y) moving at (vx, vy) per tick, paddles out of its way
+static PongState ballAt(int16_t x, int16_t y, int16_t vx, int16_t vy)
+{
+    PongState state;
+    pongReset(state, 1);
+    state.ball_x = toFixed(x);
+    state.ball_y = toFixed(y);
+    state.ball_vx = vx;
+    state.ball_vy = vy;
+    state.cpu_y = state.player_y = 1;
+    return state;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// 16 ticks at top speed from behind the player paddle overflow 8.8 int16 (120 px + 28 px
+// per tick); the ball must still end up past the goal line, not wrap around to the left
+static void test_long_sweep_past_right_goal()
+{
+    PongState state = ballAt(120, COURT_HEIGHT / 2, BALL_MAX_SPEED, 0);
+    pongSweepBall(state, 16 * TICK_FRACTION, nullptr);
+    TEST_ASSERT_TRUE(state.ball_x > BALL_MAX_X);
+}
+
+static void test_long_sweep_past_left_goal()
+{
+    PongState state = ballAt(8, COURT_HEIGHT / 2, -BALL_MAX_SPEED, 0);
+    pongSweepBall(state, 16 * TICK_FRACTION, nullptr);
+    TEST_ASSERT_TRUE(state.ball_x < BALL_MIN_X);
+}
+
+// Away from every surface, one long sweep lands where the same number of one-tick sweeps do
+static void test_long_sweep_matches_single_ticks()
+{
+    PongState longer = ballAt(40, 20, 300, 100);
+    PongState stepped = longer;
+    TEST_ASSERT_EQUAL_UINT8(0, pongSweepBall(longer, 8 * TICK_FRACTION, nullptr));
+    for (uint8_t i = 0; i < 8; i++) TEST_ASSERT_EQUAL_UINT8(0, pongSweepBall(stepped, TICK_FRACTION, nullptr));
+    TEST_ASSERT_EQUAL_INT16(stepped.ball_x, longer.ball_x);
+    TEST_ASSERT_EQUAL_INT16(stepped.ball_y, longer.ball_y);
+}
+
+// A long sweep into a wall bounces off it and stays inside the court
+static void test_long_sweep_bounces_off_wall()
+{
+    PongState state = ballAt(60, 6, 0, -BALL_MAX_SPEED);
+    PongContact contacts[MAX_CONTACTS];
+    TEST_ASSERT_EQUAL_UINT8(1, pongSweepBall(state, 4 * TICK_FRACTION, contacts));
+    TEST_ASSERT_EQUAL_UINT8(SURFACE_TOP_WALL, contacts[0].surface);
+    TEST_ASSERT_TRUE(state.ball_vy > 0);
+    TEST_ASSERT_TRUE(state.ball_y >= BALL_MIN_Y && state.ball_y <= BALL_MAX_Y);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_long_sweep_past_right_goal);
+    RUN_TEST(test_long_sweep_past_left_goal);
+    RUN_TEST(test_long_sweep_matches_single_ticks);
+    RUN_TEST(test_long_sweep_bounces_off_wall);
+    return UNITY_END();
+}
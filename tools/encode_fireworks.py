@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""Encode the fireworks animation for flash.
+
+Reads the raw 128x64 row-major bitmaps from include/fireworks_ssd1306.h (in e_allArray
+order), composites each over the court border the victory screen draws, converts it to
+SSD1306 page layout and delta-codes it against the previous frame. The first frame is
+a key frame that covers every byte, so playback does not depend on what the panel showed
+before. Writes include/fireworks_delta.h.
+
+Stream format, per frame, until all 1024 page bytes are covered:
+    0x00-0x7F  skip (n + 1) bytes that are unchanged from the previous frame
+    0x80-0xBF  (n + 1) literal bytes follow
+    0xC0-0xFF  the next byte, repeated (n + 1) times
+
+Literal and repeat runs never cross a page boundary, so each one can be sent to the panel
+as a single SSD1306 address window. Unchanged gaps of up to --merge-gap bytes between two
+changed runs of the same page are sent again as literals, which is cheaper on the bus
+than opening another window.
+
+Usage: tools/encode_fireworks.py [--merge-gap N] [input.h] [output.h]
+"""
+
+import os
+import re
+import sys
+
+WIDTH, HEIGHT = 128, 64
+FRAME_BYTES = WIDTH * HEIGHT // 8
+
+MAX_SKIP = 128
+MAX_LITERAL = 64
+MAX_REPEAT = 64
+MIN_REPEAT = 3  # Shorter runs are cheaper as literals
+
+# Opening an address window costs 8 I2C bytes of commands plus a 2 byte data header
+DEFAULT_MERGE_GAP = 10
+
+
+def load_frames(path):
+    source = open(path).read()
+    arrays = {}
+    for match in re.finditer(r"const unsigned char (\w+) \[\] PROGMEM = \{(.*?)\};", source, re.S):
+        arrays[match.group(1)] = [int(b, 16) for b in re.findall(r"0x[0-9a-fA-F]{2}", match.group(2))]
+    order = re.search(r"e_allArray\[\d+\] = \{(.*?)\}", source, re.S).group(1)
+    names = [name.strip() for name in order.split(",") if name.strip()]
+    return [(name, arrays[name]) for name in names]
+
+
+def to_pages(bitmap):
+    """Row-major 1 bpp bitmap (MSB first) over the court border -> SSD1306 page bytes."""
+    pixels = [[False] * WIDTH for _ in range(HEIGHT)]
+    for y in range(HEIGHT):
+        for x in range(WIDTH):
+            pixels[y][x] = bool(bitmap[y * (WIDTH // 8) + x // 8] & (0x80 >> (x & 7)))
+    for x in range(WIDTH):
+        pixels[0][x] = pixels[HEIGHT - 1][x] = True
+    for y in range(HEIGHT):
+        pixels[y][0] = pixels[y][WIDTH - 1] = True
+
+    pages = []
+    for page in range(HEIGHT // 8):
+        for x in range(WIDTH):
+            byte = 0
+            for bit in range(8):
+                if pixels[page * 8 + bit][x]:
+                    byte |= 1 << bit
+            pages.append(byte)
+    return pages
+
+
+def changed_mask(prev, cur, merge_gap):
+    """Bytes to send for this frame: the changed ones plus short gaps between them."""
+    if prev is None:
+        return [True] * len(cur)
+    mask = [a != b for a, b in zip(prev, cur)]
+    for page_start in range(0, len(cur), WIDTH):
+        last_changed = None
+        for i in range(page_start, page_start + WIDTH):
+            if not mask[i]:
+                continue
+            if last_changed is not None and 0 < i - last_changed - 1 <= merge_gap:
+                for j in range(last_changed + 1, i):
+                    mask[j] = True
+            last_changed = i
+    return mask
+
+
+def page_end(i):
+    return (i // WIDTH + 1) * WIDTH
+
+
+def repeat_length(mask, cur, i):
+    j = i
+    while j < page_end(i) and j - i < MAX_REPEAT and mask[j] and cur[j] == cur[i]:
+        j += 1
+    return j - i
+
+
+def encode_frame(prev, cur, merge_gap):
+    mask = changed_mask(prev, cur, merge_gap)
+    out = []
+    i = 0
+    while i < len(cur):
+        if not mask[i]:
+            j = i
+            while j < len(cur) and j - i < MAX_SKIP and not mask[j]:
+                j += 1
+            out.append(j - i - 1)
+            i = j
+            continue
+
+        run = repeat_length(mask, cur, i)
+        if run >= MIN_REPEAT:
+            out += [0xC0 | (run - 1), cur[i]]
+            i += run
+            continue
+
+        # Literal run: bytes to send up to the next skip, worthwhile repeat or page end
+        j = i
+        while j < page_end(i) and j - i < MAX_LITERAL and mask[j]:
+            if j > i and repeat_length(mask, cur, j) >= MIN_REPEAT:
+                break
+            j += 1
+        out.append(0x80 | (j - i - 1))
+        out += cur[i:j]
+        i = j
+    return out
+
+
+def decode_frame(prev, stream, pos):
+    """Reference decoder, used to verify the encoder output."""
+    frame = list(prev)
+    windows = 0
+    i = 0
+    while i < FRAME_BYTES:
+        token = stream[pos]
+        pos += 1
+        count = (token & 0x7F if token < 0x80 else token & 0x3F) + 1
+        if token < 0x80:
+            i += count
+            continue
+        assert i // WIDTH == (i + count - 1) // WIDTH
+        windows += 1
+        if token < 0xC0:
+            frame[i:i + count] = stream[pos:pos + count]
+            pos += count
+        else:
+            frame[i:i + count] = [stream[pos]] * count
+            pos += 1
+        i += count
+    return frame, pos, windows
+
+
+def main():
+    args = sys.argv[1:]
+    merge_gap = DEFAULT_MERGE_GAP
+    if args[:1] == ["--merge-gap"]:
+        merge_gap = int(args[1])
+        args = args[2:]
+
+    root = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+    src = args[0] if len(args) > 0 else os.path.join(root, "include", "fireworks_ssd1306.h")
+    dst = args[1] if len(args) > 1 else os.path.join(root, "include", "fireworks_delta.h")
+
+    frames = load_frames(src)
+    stream = []
+    prev = None
+    for _, bitmap in frames:
+        cur = to_pages(bitmap)
+        stream += encode_frame(prev, cur, merge_gap)
+        prev = cur
+
+    # Round trip before writing anything, and total up what playback sends to the panel
+    prev, pos, windows = [0xAA] * FRAME_BYTES, 0, 0
+    for _, bitmap in frames:
+        prev, pos, frame_windows = decode_frame(prev, stream, pos)
+        windows += frame_windows
+        assert prev == to_pages(bitmap)
+    assert pos == len(stream)
+
+    raw_bytes = sum(len(bitmap) for _, bitmap in frames)
+    lines = [
+        "// Generated by tools/encode_fireworks.py from include/fireworks_ssd1306.h, do not edit.",
+        "//",
+        "// Fireworks victory animation: %d frames of %dx%d in SSD1306 page layout, with the court" % (len(frames), WIDTH, HEIGHT),
+        "// border baked in. The first frame is a key frame, the others are delta-coded against the",
+        "// previous frame. %d bytes, down from %d raw bitmap bytes. Decode with fireworks.h." % (len(stream), raw_bytes),
+        "//",
+        "// Stream format, per frame, until all %d page bytes are covered:" % FRAME_BYTES,
+        "//   0x00-0x7F  skip (n + 1) bytes that are unchanged from the previous frame",
+        "//   0x80-0xBF  (n + 1) literal bytes follow",
+        "//   0xC0-0xFF  the next byte, repeated (n + 1) times",
+        "// Literal and repeat runs stay within one page (one panel address window each), with",
+        "// unchanged gaps of up to %d bytes resent as literals. %d windows for the whole animation." % (merge_gap, windows),
+        "#ifndef FIREWORKS_DELTA_H",
+        "#define FIREWORKS_DELTA_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "const uint16_t FIREWORKS_FRAME_BYTES = %d;" % FRAME_BYTES,
+        "const uint8_t FIREWORKS_FRAME_COUNT = %d;" % len(frames),
+        "",
+        "const uint8_t fireworks_stream[] PROGMEM = {",
+    ]
+    for i in range(0, len(stream), 16):
+        chunk = stream[i:i + 16]
+        last = i + 16 >= len(stream)
+        lines.append("\t" + ", ".join("0x%02x" % b for b in chunk) + ("" if last else ","))
+    lines += ["};", "", "#endif", ""]
+
+    with open(dst, "w") as f:
+        f.write("\n".join(lines))
+    print("%s: %d frames, %d -> %d bytes, %d panel windows" % (os.path.relpath(dst, root), len(frames), raw_bytes, len(stream), windows))
+
+
+if __name__ == "__main__":
+    main()
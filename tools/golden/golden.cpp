@@ -0,0 +1,487 @@
+// Golden-frame check of the incremental rally renderer, built by the golden env on the
+// native HAL. Random sessions (or a recorded match) are played tick by tick through the
+// game's own drawRally() and display flushes; a model of the SSD1306 rebuilds the panel
+// RAM from the bus traffic, and after every frame its hash is compared with the hash of a
+// full redraw of the same state. The first frame that differs is reported with the pixels
+// that differ, and the run stops with exit code 1.
+//
+//   golden [--sessions N] [--ticks N] [--seed S] [--frame-ticks N]
+//          [--flush async|dirty|full] [--pace] [--trace file]
+//
+//   --sessions     random sessions to play (default 100), each with its own seed (S, S+1, ...)
+//   --ticks        ticks per session (default 20000)
+//   --frame-ticks  ticks between frames (default 1, every tick; the game draws every ~4)
+//   --flush        how frames reach the panel: flushAsync() as in a rally (default),
+//                  flushDirty() or display()
+//   --pace         give the bus only the frame's ticks of time before the next frame, as
+//                  the game loop does: frames still on the bus are not compared, and their
+//                  dirty marks carry over to the next flush
+//   --trace        play the match saved in this EEPROM image (see pong_record.h) instead
+//
+// Menu and banner screens have no reference renderer: a hash of each as the panel shows it
+// is printed first, and the RAM buffer and page renderer (PONG_PAGE_RENDER) builds must
+// print the same one. The last line has a hash over every frame compared. Without --pace (where bus timing
+// decides which frames are compared) it must not change when the renderer is optimized,
+// and I2C and SPI builds print the same one.
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <pong_display.h>
+#include <pong_layout.h>
+#include <pong_record.h>
+#include <pong_render.h>
+#include <pong_sim.h>
+#include <pong_twi.h>
+
+#include <native_hal.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#define FRAME_BYTES     (SCREEN_WIDTH * SCREEN_HEIGHT / 8)
+
+// Most differing pixels listed for a divergent frame
+#define REPORT_PIXELS   16
+
+#if PONG_DISPLAY_SPI
+static PongDisplay display(PanelSPI(OLED_DC, -1, OLED_CS));
+#else
+static PongDisplay display(PanelI2C(-1));
+#endif
+
+// Panel model: SSD1306 display RAM and the address pointer, driven by the command and data
+// bytes on the bus
+
+static uint8_t panel[FRAME_BYTES];
+static uint8_t addressing = 2;              // 0 horizontal, 1 vertical, 2 page (reset default)
+static uint8_t col_start = 0, col_end = SCREEN_WIDTH - 1;
+static uint8_t page_start = 0, page_end = SCREEN_HEIGHT / 8 - 1;
+static uint8_t column = 0, page = 0;
+static uint8_t command;                     // Command waiting for its arguments
+static uint8_t arguments[6];
+static uint8_t argument_count, arguments_left;
+
+// Argument bytes that follow each SSD1306 command
+static uint8_t commandArguments(uint8_t value)
+{
+    switch (value)
+    {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD8: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void panelExecute()
+{
+    switch (command)
+    {
+    case 0x20:  // Memory addressing mode
+        addressing = arguments[0] & 0x03;
+        break;
+    case 0x21:  // Column window
+        col_start = arguments[0] & 0x7F;
+        col_end = arguments[1] & 0x7F;
+        column = col_start;
+        break;
+    case 0x22:  // Page window
+        page_start = arguments[0] & 0x07;
+        page_end = arguments[1] & 0x07;
+        page = page_start;
+        break;
+    default:
+        // Page addressing: page start and column nibbles
+        if (command >= 0xB0 && command <= 0xB7) page = command & 0x07;
+        else if (command <= 0x0F) column = (column & 0xF0) | command;
+        else if (command <= 0x1F) column = (column & 0x0F) | ((command & 0x07) << 4);
+        break;
+    }
+}
+
+static void panelCommand(uint8_t value)
+{
+    if (arguments_left)
+    {
+        arguments[argument_count++] = value;
+        if (--arguments_left) return;
+    }
+    else
+    {
+        command = value;
+        argument_count = 0;
+        arguments_left = commandArguments(value);
+        if (arguments_left) return;
+    }
+    panelExecute();
+}
+
+static void panelData(uint8_t value)
+{
+    panel[page * SCREEN_WIDTH + column] = value;
+    switch (addressing)
+    {
+    case 0:     // Horizontal: across the column window, then down the page window
+        if (column != col_end) column++;
+        else
+        {
+            column = col_start;
+            page = page == page_end ? page_start : page + 1;
+        }
+        break;
+    case 1:     // Vertical: down the page window, then across the column window
+        if (page != page_end) page++;
+        else
+        {
+            page = page_start;
+            column = column == col_end ? col_start : column + 1;
+        }
+        break;
+    default:    // Page: along the page, wrapping within it
+        column = (column + 1) % SCREEN_WIDTH;
+        break;
+    }
+}
+
+// I2C: the control byte says whether the rest of the transaction is commands or data
+static void i2cPanel(uint8_t address, const uint8_t *data, uint8_t length)
+{
+    (void)address;
+    if (!length) return;
+    bool is_data = data[0] & 0x40;
+    for (uint8_t i = 1; i < length; i++)
+    {
+        if (is_data) panelData(data[i]);
+        else panelCommand(data[i]);
+    }
+}
+
+// SPI: the data/command pin does, while chip select is low
+static void spiPanel(uint8_t value)
+{
+    if (nativeGetPin(OLED_CS) != LOW) return;
+    if (nativeGetPin(OLED_DC) == HIGH) panelData(value);
+    else panelCommand(value);
+}
+
+// Reference renderer: the whole rally screen drawn from scratch, straight into page layout
+
+static void setPixel(uint8_t *frame, int16_t x, int16_t y)
+{
+    if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) return;
+    frame[(y >> 3) * SCREEN_WIDTH + x] |= 1 << (y & 7);
+}
+
+static void referenceFrame(const PongState &state, uint8_t *frame)
+{
+    memset(frame, 0, FRAME_BYTES);
+    for (int16_t x = 0; x < COURT_WIDTH; x++)
+    {
+        setPixel(frame, x, 0);
+        setPixel(frame, x, COURT_HEIGHT - 1);
+    }
+    for (int16_t y = 0; y < COURT_HEIGHT; y++)
+    {
+        setPixel(frame, 0, y);
+        setPixel(frame, COURT_WIDTH - 1, y);
+    }
+    for (int16_t y = 0; y < PADDLE_LENGTH; y++)
+    {
+        setPixel(frame, CPU_X, state.cpu_y + y);
+        setPixel(frame, PLAYER_X, state.player_y + y);
+    }
+    setPixel(frame, ballPixelX(state), ballPixelY(state));
+}
+
+// 64-bit multiply-xorshift over the frame, eight bytes at a time
+static uint64_t frameHash(const uint8_t *frame)
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ULL;
+    for (uint16_t i = 0; i < FRAME_BYTES; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, frame + i, sizeof(word));
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+// Session being played
+
+enum FlushKind
+{
+    FLUSH_ASYNC,
+    FLUSH_DIRTY,
+    FLUSH_FULL
+};
+
+static FlushKind flush_kind = FLUSH_ASYNC;
+static bool pace = false;
+static uint8_t frame_ticks = 1;
+
+static PongState state;
+static RallyView view;
+static uint32_t session_seed;
+
+static uint64_t frames_checked, frames_skipped, ticks_played;
+static uint64_t chain_hash = 0;
+
+static void reportDivergence(const uint8_t *reference, uint64_t panel_hash, uint64_t reference_hash)
+{
+    printf("diverged: session seed %lu, tick %lu (score %u:%u)\n", (unsigned long)session_seed,
+           (unsigned long)state.tick, state.cpu_score, state.player_score);
+    printf("  panel hash 0x%016llx, reference 0x%016llx\n",
+           (unsigned long long)panel_hash, (unsigned long long)reference_hash);
+
+    uint8_t listed = 0;
+    for (uint16_t i = 0; i < FRAME_BYTES && listed < REPORT_PIXELS; i++)
+    {
+        uint8_t difference = panel[i] ^ reference[i];
+        for (uint8_t bit = 0; bit < 8 && listed < REPORT_PIXELS; bit++)
+        {
+            if (!(difference & (1 << bit))) continue;
+            printf("  pixel (%u, %u): panel %s, reference %s\n", i % SCREEN_WIDTH, (i / SCREEN_WIDTH) * 8 + bit,
+                   panel[i] & (1 << bit) ? "on" : "off", reference[i] & (1 << bit) ? "on" : "off");
+            listed++;
+        }
+    }
+    printf("  ball (%d, %d), cpu paddle %u, player paddle %u\n", ballPixelX(state), ballPixelY(state),
+           state.cpu_y, state.player_y);
+    printf("reproduce with --seed %lu --sessions 1\n", (unsigned long)session_seed);
+}
+
+// Let the bus run for 'ticks' ticks of virtual time, polled the way loop() polls it
+static void serviceBus(uint8_t ticks)
+{
+    unsigned long until = micros() + ticks * 1000UL;
+    while ((long)(micros() - until) < 0) twiService();
+}
+
+// Send what was drawn the selected way; false if the panel is left out of date for now
+static bool flushFrame()
+{
+    switch (flush_kind)
+    {
+    case FLUSH_ASYNC:   return display.flushAsync();
+    case FLUSH_DIRTY:   display.flushDirty(); return true;
+    case FLUSH_FULL:    display.display(); return true;
+    }
+    return true;
+}
+
+// Draw and flush the current state, then check the panel. Returns false if it diverged.
+static bool checkFrame()
+{
+    drawRally(display, view, state);
+
+    bool sent = flushFrame();
+    if (pace) serviceBus(frame_ticks);
+    else twiFinish();
+
+    // Part of the frame is still on the bus (or waiting for it): nothing to compare yet
+    if (!sent || twiBusy())
+    {
+        frames_skipped++;
+        return true;
+    }
+
+    uint8_t reference[FRAME_BYTES];
+    referenceFrame(view.drawn, reference);
+    uint64_t panel_hash = frameHash(panel);
+    uint64_t reference_hash = frameHash(reference);
+    if (panel_hash != reference_hash)
+    {
+        reportDivergence(reference, panel_hash, reference_hash);
+        return false;
+    }
+    chain_hash = (chain_hash ^ panel_hash) * 0x100000001B3ULL;
+    frames_checked++;
+    return true;
+}
+
+// Panel hash after flushing the screen just drawn, chained into 'hash'
+static void chainScreen(uint64_t &hash)
+{
+    flushFrame();
+    twiFinish();
+    hash = (hash ^ frameHash(panel)) * 0x100000001B3ULL;
+}
+
+// Every other screen of the game, in the order it shows them, hashed as the panel shows
+// them. There is no reference renderer for text: the RAM buffer and page renderer builds
+// must print the same hash.
+static uint64_t screensHash()
+{
+    uint64_t hash = 0;
+    drawMenu(display);
+    chainScreen(hash);
+    drawMenuPress(display);
+    chainScreen(hash);
+
+    PongInputs inputs = { false, true };
+    pongReset(state, 1);
+    drawCourt(display, view);
+    for (uint32_t tick = 0; tick < 700; tick++) pongStep(state, inputs);
+    drawRally(display, view, state);
+    chainScreen(hash);
+    drawGoalBanner(display, UI_CPU_SCORES, 3, 4);
+    chainScreen(hash);
+
+    drawCourt(display, view);
+    drawRally(display, view, state);
+    chainScreen(hash);
+    drawGoalBanner(display, UI_PLAYER_SCORES, 10, 255);
+    chainScreen(hash);
+
+    drawVictoryBanner(display, UI_CPU_WINS);
+    chainScreen(hash);
+    drawVictoryBanner(display, UI_PLAYER_WINS);
+    chainScreen(hash);
+    return hash;
+}
+
+// New court, as every serve draws it
+static bool startCourt()
+{
+    drawCourt(display, view);
+    return checkFrame();
+}
+
+// Random buttons, each choice held for 1..64 ticks
+static PongInputs randomInputs(uint32_t &rng, uint8_t &hold, PongInputs &inputs)
+{
+    if (!hold)
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        hold = 1 + (rng & 63);
+        uint8_t choice = (rng >> 6) % 3;
+        inputs.up = choice == 1;
+        inputs.down = choice == 2;
+    }
+    hold--;
+    return inputs;
+}
+
+static bool playRandom(uint32_t seed, uint32_t ticks)
+{
+    session_seed = seed;
+    pongReset(state, seed);
+    if (!startCourt()) return false;
+
+    uint32_t rng = seed * 2654435761u + 1;
+    uint8_t hold = 0;
+    PongInputs inputs = { false, false };
+    for (uint32_t tick = 1; tick <= ticks; tick++)
+    {
+        PongEvent event = pongStep(state, randomInputs(rng, hold, inputs));
+        ticks_played++;
+        if (event != EVENT_NONE)
+        {
+            if (!startCourt()) return false;
+        }
+        else if (tick % frame_ticks == 0)
+        {
+            if (!checkFrame()) return false;
+        }
+    }
+    return true;
+}
+
+static bool playTrace()
+{
+    if (!replayBegin(state))
+    {
+        printf("no trace in the EEPROM image\n");
+        return false;
+    }
+    session_seed = 0;
+    if (!startCourt()) return false;
+
+    PongInputs inputs;
+    uint32_t tick = 0;
+    while (replayNext(inputs))
+    {
+        PongEvent event = pongStep(state, inputs);
+        ticks_played++;
+        tick++;
+        if (event != EVENT_NONE)
+        {
+            if (!startCourt()) return false;
+        }
+        else if (tick % frame_ticks == 0)
+        {
+            if (!checkFrame()) return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t sessions = 100;
+    uint32_t ticks = 20000;
+    uint32_t seed = 1;
+    const char *trace = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        const char *value = i + 1 < argc ? argv[i + 1] : "";
+        if (!strcmp(argv[i], "--pace"))
+        {
+            pace = true;
+            continue;
+        }
+        if (!strcmp(argv[i], "--sessions")) sessions = strtoul(value, nullptr, 10);
+        else if (!strcmp(argv[i], "--ticks")) ticks = strtoul(value, nullptr, 10);
+        else if (!strcmp(argv[i], "--seed")) seed = strtoul(value, nullptr, 10);
+        else if (!strcmp(argv[i], "--frame-ticks")) frame_ticks = atoi(value) > 0 ? atoi(value) : 1;
+        else if (!strcmp(argv[i], "--trace")) trace = value;
+        else if (!strcmp(argv[i], "--flush") && !strcmp(value, "async")) flush_kind = FLUSH_ASYNC;
+        else if (!strcmp(argv[i], "--flush") && !strcmp(value, "dirty")) flush_kind = FLUSH_DIRTY;
+        else if (!strcmp(argv[i], "--flush") && !strcmp(value, "full")) flush_kind = FLUSH_FULL;
+        else
+        {
+            fprintf(stderr, "bad option %s %s\n", argv[i], value);
+            return 2;
+        }
+        i++;
+    }
+    if (trace && !nativeEEPROMLoad(trace))
+    {
+        fprintf(stderr, "cannot read %s\n", trace);
+        return 2;
+    }
+
+    // Power-up panel RAM is garbage: bytes the renderer never sends must show up
+    memset(panel, 0xA5, sizeof(panel));
+    nativeSetI2CSink(i2cPanel);
+    nativeSetSPISink(spiPanel);
+    display.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+
+    printf("screens hash 0x%016llx\n", (unsigned long long)screensHash());
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool ok = true;
+    if (trace) ok = playTrace();
+    for (uint32_t i = 0; ok && !trace && i < sessions; i++) ok = playRandom(seed + i, ticks);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%llu ticks, %llu frames checked, %llu still on the bus, in %.2f s (%.2f M frames/min)\n",
+           (unsigned long long)ticks_played, (unsigned long long)frames_checked,
+           (unsigned long long)frames_skipped, seconds, frames_checked / seconds * 60 / 1e6);
+    if (!ok) return 1;
+    printf("frames hash 0x%016llx\n", (unsigned long long)chain_hash);
+    return 0;
+}
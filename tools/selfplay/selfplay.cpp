@@ -0,0 +1,319 @@
+// Headless self-play for balance tuning: the CPU AI against scripted players, many matches
+// per parameter set, on every host core. Only the simulation (pong_sim, pong_ai) is linked:
+// no display, no Arduino core, and nothing is allocated while matches run.
+//
+//   selfplay [--matches N] [--levels L,...] [--players P,...] [--win W,...]
+//            [--threads T] [--seed S]
+//
+//   --matches  matches per parameter set (default 20000)
+//   --levels   CPU levels 0..42, or "serve" to draw a new level every serve as the game
+//              does (default serve,0,14,28,42)
+//   --players  idle, random (holds a random direction, changed every 40 ticks) or tracker
+//              (follows the ball with a reaction delay) (default random,tracker)
+//   --win      points to win a match (default 5)
+//   --threads  worker threads (default: every core)
+//
+// Paddle length and ball speeds are build options of the simulation (PONG_PADDLE_LENGTH,
+// PONG_BALL_SERVE_SPEED, PONG_BALL_MAX_SPEED, PONG_BALL_SPEEDUP in pong_sim.h); build once
+// per value to compare them.
+#include <pong_sim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "work_pool.h"
+
+// Level value meaning "new random level every serve"
+#define LEVEL_SERVE     -1
+
+// Matches handed out per task
+#define MATCHES_PER_TASK 64
+
+// A match still running after this many ticks (~17 minutes of play) is called off
+#define MATCH_TICK_LIMIT 1000000UL
+
+// Scripted players
+
+enum PlayerKind
+{
+    PLAYER_IDLE,
+    PLAYER_RANDOM,
+    PLAYER_TRACKER
+};
+
+static const char *const player_names[] = { "idle", "random", "tracker" };
+
+// Ticks the random player keeps a direction
+#define RANDOM_HOLD_TICKS   40
+// Ticks the tracker takes to notice the ball coming its way
+#define TRACKER_REACTION    20
+// Pixels off center the tracker accepts before it moves
+#define TRACKER_DEAD_ZONE   2
+
+struct Player
+{
+    PlayerKind kind;
+    uint32_t rng;
+    uint8_t hold;       // Random: ticks left on the current choice
+    uint8_t choice;     // Random: 0 nothing, 1 up, 2 down
+    uint8_t seen;       // Tracker: ticks the ball has been coming towards the player
+};
+
+static uint32_t nextRandom(uint32_t &x)
+{
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+static void playerReset(Player &player, PlayerKind kind, uint32_t seed)
+{
+    player.kind = kind;
+    player.rng = seed ? seed : 1;
+    player.hold = player.choice = player.seen = 0;
+}
+
+static PongInputs playerInputs(Player &player, const PongState &state)
+{
+    PongInputs inputs = { false, false };
+    switch (player.kind)
+    {
+    case PLAYER_IDLE:
+        break;
+    case PLAYER_RANDOM:
+        if (!player.hold)
+        {
+            player.hold = RANDOM_HOLD_TICKS;
+            player.choice = nextRandom(player.rng) % 3;
+        }
+        player.hold--;
+        inputs.up = player.choice == 1;
+        inputs.down = player.choice == 2;
+        break;
+    case PLAYER_TRACKER:
+    {
+        // Head for the ball once it has been coming this way for a while, else the middle
+        player.seen = state.ball_vx > 0 ? (player.seen < 255 ? player.seen + 1 : 255) : 0;
+        int16_t target = player.seen >= TRACKER_REACTION ? ballPixelY(state) : COURT_HEIGHT / 2;
+        int16_t center = state.player_y + half_paddle;
+        inputs.up = target < center - TRACKER_DEAD_ZONE;
+        inputs.down = target > center + TRACKER_DEAD_ZONE;
+        break;
+    }
+    }
+    return inputs;
+}
+
+// Parameter sets and their results
+
+struct ParamSet
+{
+    int level;              // 0..AI_MAX_LEVEL or LEVEL_SERVE
+    PlayerKind player;
+    uint8_t win_score;
+};
+
+struct Stats
+{
+    uint64_t matches;
+    uint64_t player_wins;
+    uint64_t timeouts;
+    uint64_t points;
+    uint64_t ticks;
+    uint32_t longest_rally;
+
+    void add(const Stats &other)
+    {
+        matches += other.matches;
+        player_wins += other.player_wins;
+        timeouts += other.timeouts;
+        points += other.points;
+        ticks += other.ticks;
+        if (other.longest_rally > longest_rally) longest_rally = other.longest_rally;
+    }
+};
+
+struct Task
+{
+    uint32_t set;
+    uint32_t first_match;
+    uint32_t matches;
+};
+
+static void fixLevel(PongState &state, int level)
+{
+    if (level == LEVEL_SERVE) return;
+    aiSetLevel(state.ai, level);
+    aiPlan(state);
+}
+
+static void playMatch(const ParamSet &set, uint32_t seed, Stats &stats)
+{
+    PongState state;
+    pongReset(state, seed);
+    fixLevel(state, set.level);
+
+    Player player;
+    playerReset(player, set.player, seed * 2654435761u);
+
+    uint32_t rally_start = 0;
+    while (state.player_score < set.win_score && state.cpu_score < set.win_score)
+    {
+        if (state.tick >= MATCH_TICK_LIMIT)
+        {
+            stats.timeouts++;
+            break;
+        }
+        if (pongStep(state, playerInputs(player, state)) == EVENT_NONE) continue;
+
+        uint32_t rally = state.tick - rally_start;
+        if (rally > stats.longest_rally) stats.longest_rally = rally;
+        rally_start = state.tick;
+        stats.points++;
+        fixLevel(state, set.level);
+    }
+
+    stats.matches++;
+    stats.ticks += state.tick;
+    if (state.player_score >= set.win_score) stats.player_wins++;
+}
+
+// Command line
+
+static std::vector<std::string> splitList(const char *text)
+{
+    std::vector<std::string> items;
+    std::string item;
+    for (const char *c = text; ; c++)
+    {
+        if (*c == ',' || !*c)
+        {
+            if (!item.empty()) items.push_back(item);
+            item.clear();
+            if (!*c) break;
+        }
+        else
+        {
+            item += *c;
+        }
+    }
+    return items;
+}
+
+static bool parsePlayer(const std::string &name, PlayerKind &kind)
+{
+    for (unsigned i = 0; i < sizeof(player_names) / sizeof(player_names[0]); i++)
+    {
+        if (name == player_names[i])
+        {
+            kind = (PlayerKind)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t matches = 20000;
+    const char *levels_arg = "serve,0,14,28,42";
+    const char *players_arg = "random,tracker";
+    const char *win_arg = "5";
+    unsigned threads = std::thread::hardware_concurrency();
+    uint32_t seed = 1;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--matches")) matches = strtoul(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--levels")) levels_arg = argv[i + 1];
+        else if (!strcmp(argv[i], "--players")) players_arg = argv[i + 1];
+        else if (!strcmp(argv[i], "--win")) win_arg = argv[i + 1];
+        else if (!strcmp(argv[i], "--threads")) threads = strtoul(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--seed")) seed = strtoul(argv[i + 1], nullptr, 10);
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // Every combination of the listed values
+    std::vector<ParamSet> sets;
+    for (const std::string &win : splitList(win_arg))
+    {
+        for (const std::string &player : splitList(players_arg))
+        {
+            for (const std::string &level : splitList(levels_arg))
+            {
+                ParamSet set;
+                set.level = level == "serve" ? LEVEL_SERVE : atoi(level.c_str());
+                set.win_score = atoi(win.c_str());
+                if (!parsePlayer(player, set.player) || set.level > AI_MAX_LEVEL || !set.win_score)
+                {
+                    fprintf(stderr, "bad parameter set: level %s, player %s, win %s\n",
+                            level.c_str(), player.c_str(), win.c_str());
+                    return 1;
+                }
+                sets.push_back(set);
+            }
+        }
+    }
+
+    WorkPool<Task> pool(threads);
+    for (uint32_t set = 0; set < sets.size(); set++)
+    {
+        for (uint32_t first = 0; first < matches; first += MATCHES_PER_TASK)
+        {
+            Task task = { set, first, matches - first < MATCHES_PER_TASK ? matches - first : MATCHES_PER_TASK };
+            pool.add(task);
+        }
+    }
+
+    // One row of results per worker, merged at the end, so workers never share counters
+    std::vector<std::vector<Stats>> results(pool.workers(), std::vector<Stats>(sets.size(), Stats()));
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    pool.run([&](unsigned worker, const Task &task)
+    {
+        Stats &stats = results[worker][task.set];
+        for (uint32_t i = 0; i < task.matches; i++)
+        {
+            // Same seeds for every set, so sets differ only by their parameters
+            playMatch(sets[task.set], seed + (task.first_match + i) * 7919u, stats);
+        }
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("paddle %d px, serve speed %d, max speed %d, speedup %d (8.8 px/tick)\n",
+           PADDLE_LENGTH, BALL_SERVE_SPEED, BALL_MAX_SPEED, BALL_SPEEDUP);
+    printf("%-6s %-8s %4s %9s %8s %12s %12s %10s %9s\n", "level", "player", "win", "matches",
+           "player%", "ticks/match", "ticks/point", "max rally", "timeouts");
+
+    uint64_t total_ticks = 0;
+    for (uint32_t set = 0; set < sets.size(); set++)
+    {
+        Stats stats = Stats();
+        for (unsigned worker = 0; worker < pool.workers(); worker++) stats.add(results[worker][set]);
+        total_ticks += stats.ticks;
+
+        char level[8];
+        if (sets[set].level == LEVEL_SERVE) snprintf(level, sizeof(level), "serve");
+        else snprintf(level, sizeof(level), "%d", sets[set].level);
+        printf("%-6s %-8s %4d %9llu %8.1f %12.0f %12.0f %10u %9llu\n", level, player_names[sets[set].player],
+               sets[set].win_score, (unsigned long long)stats.matches,
+               stats.matches ? 100.0 * stats.player_wins / stats.matches : 0.0,
+               stats.matches ? (double)stats.ticks / stats.matches : 0.0,
+               stats.points ? (double)stats.ticks / stats.points : 0.0,
+               stats.longest_rally, (unsigned long long)stats.timeouts);
+    }
+
+    printf("%llu ticks in %.2f s on %u threads: %.1f M ticks/s, %.1f M ticks/s per thread\n",
+           (unsigned long long)total_ticks, seconds, pool.workers(), total_ticks / seconds / 1e6,
+           total_ticks / seconds / 1e6 / pool.workers());
+    return 0;
+}
@@ -0,0 +1,85 @@
+#ifndef SELFPLAY_WORK_POOL_H
+#define SELFPLAY_WORK_POOL_H
+
+#include <stdint.h>
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of tasks run on a pool of threads with work stealing: every worker starts with
+// its own share of the tasks, takes them from the back of its queue, and once that is empty
+// takes from the front of the others' queues. Tasks never create new tasks, so a worker
+// that finds every queue empty is done.
+template <typename Task>
+class WorkPool
+{
+public:
+    explicit WorkPool(unsigned workers) : queues(workers ? workers : 1) {}
+
+    unsigned workers() const { return (unsigned)queues.size(); }
+
+    // Deal tasks round robin; only before run()
+    void add(const Task &task)
+    {
+        queues[next_queue].tasks.push_back(task);
+        next_queue = (next_queue + 1) % queues.size();
+    }
+
+    // Run every task as body(worker, task) and return once all are done. 'body' is called
+    // concurrently from different workers; each worker index is used by one thread only.
+    template <typename Body>
+    void run(Body body)
+    {
+        std::vector<std::thread> threads;
+        for (unsigned worker = 0; worker < queues.size(); worker++)
+        {
+            threads.emplace_back([this, worker, &body]()
+            {
+                Task task;
+                while (take(worker, task)) body(worker, task);
+            });
+        }
+        for (std::thread &thread : threads) thread.join();
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    // Own work first (newest, still warm), then the oldest task of the next non-empty queue
+    bool take(unsigned worker, Task &task)
+    {
+        {
+            Queue &own = queues[worker];
+            std::lock_guard<std::mutex> guard(own.lock);
+            if (!own.tasks.empty())
+            {
+                task = own.tasks.back();
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (unsigned i = 1; i < queues.size(); i++)
+        {
+            Queue &victim = queues[(worker + i) % queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty())
+            {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<Queue> queues;
+    unsigned next_queue = 0;
+};
+
+#endif